@@ -0,0 +1,69 @@
+// Copyright Contributors to the Pystring project.
+// SPDX-License-Identifier: BSD-3-Clause
+// https://github.com/imageworks/pystring/blob/master/LICENSE
+
+
+// Times the small, hot functions that benefit from inlining. Built twice by CMake, against the
+// compiled library (pystring_bench) and in PYSTRING_HEADER_ONLY mode (pystring_bench_header_only),
+// so the two can be compared directly. Heap allocations are counted alongside the timings.
+
+#include "pystring.h"
+#include "unittest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+PYSTRING_ALLOCATION_HOOKS()
+
+namespace
+{
+    // Keeps the optimizer from discarding the work being timed.
+    volatile std::size_t sink;
+
+    template< typename Func >
+    void run( const char * name, const std::vector< std::string > & paths, Func func )
+    {
+        const int rounds = 200;
+        std::size_t total = 0;
+        std::size_t allocs_before = unit_test_allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for ( int round = 0; round < rounds; ++round )
+        {
+            for ( const std::string & path : paths ) total += func( path );
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        std::size_t allocs = unit_test_allocations.load() - allocs_before;
+        sink = total;
+
+        double calls = (double) rounds * (double) paths.size();
+        double ns = (double) std::chrono::duration_cast< std::chrono::nanoseconds >( elapsed ).count();
+        std::printf( "%-12s %8.2f ns/call %6.2f allocs/call\n", name, ns / calls, (double) allocs / calls );
+    }
+}
+
+int main()
+{
+    std::vector< std::string > paths;
+    for ( int i = 0; i < 10000; ++i )
+    {
+        paths.push_back( "/shows/seq" + std::to_string( i % 37 ) + "/shot_" + std::to_string( i ) + "/render.v" + std::to_string( i % 9 ) + ( i % 3 ? ".exr" : ".mesh" ) );
+    }
+
+#if defined(PYSTRING_HEADER_ONLY)
+    std::printf( "pystring header-only\n" );
+#else
+    std::printf( "pystring library\n" );
+#endif
+
+    run( "startswith", paths, []( const std::string & s ) { return (std::size_t) pystring::startswith( s, "/shows/" ); } );
+    run( "endswith", paths, []( const std::string & s ) { return (std::size_t) pystring::endswith( s, ".mesh" ); } );
+    run( "find", paths, []( const std::string & s ) { return (std::size_t) pystring::find( s, "shot_" ); } );
+    run( "slice", paths, []( const std::string & s ) { return pystring::slice( s, 1, 6 ).size(); } );
+
+    pystring::small_vector< std::string_view, 16 > parts;
+    run( "split_view", paths, [&parts]( const std::string & s ) { pystring::split_view( s, parts, "/" ); return parts.size(); } );
+
+    return 0;
+}
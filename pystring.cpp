@@ -3,40 +3,91 @@
 // https://github.com/imageworks/pystring/blob/master/LICENSE
 
 
+#ifndef INCLUDED_PYSTRING_CPP
+#define INCLUDED_PYSTRING_CPP
+
 #include "pystring.h"
+#include "pystring_unicode_tables.h"
 
 #include <algorithm>
-#include <cctype>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <clocale>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <limits>
+#include <mutex>
 #include <sstream>
 #include <string_view>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PYSTRING_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(PYSTRING_HAVE_SSE2) && defined(__SSSE3__)
+#define PYSTRING_HAVE_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// AVX2 kernels are compiled for that target alone and only called after a runtime CPU check,
+// so they need compilers that can target a single function: GCC and Clang through the target
+// attribute, MSVC without one.
+#if defined(PYSTRING_HAVE_SSE2) && ( defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86) ) && \
+    ( defined(__GNUC__) || defined(_MSC_VER) )
+#define PYSTRING_HAVE_AVX2 1
+#include <immintrin.h>
+#if defined(__GNUC__)
+#define PYSTRING_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#else
+#define PYSTRING_TARGET_AVX2
+#endif
+#endif
+
+#if defined(_WIN32)
+#include <climits>
+#include <io.h>
+#else
+#include <cerrno>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define PYSTRING_BIG_ENDIAN 1
+#endif
+
 namespace pystring
 {
 
 #if defined(_WIN32) || defined(_WIN64) || defined(_WINDOWS) || defined(_MSC_VER)
 #ifndef WINDOWS
 #define WINDOWS
+#define PYSTRING_DEFINED_WINDOWS
 #endif
 #endif
 
 // This definition codes from configure.in in the python src.
-// Strictly speaking this limits us to str sizes of 2**31.
-// Should we wish to handle this limit, we could use an architecture
-// specific #defines and read from ssize_t (unistd.h) if the header exists.
-// But in the meantime, the use of int assures maximum arch compatibility.
-// This must also equal the size used in the end = MAX_32BIT_INT default arg.
-
-typedef int Py_ssize_t;
-const std::string forward_slash = "/";
-const std::string double_forward_slash = "//";
-const std::string triple_forward_slash = "///";
-const std::string double_back_slash = "\\";
-const std::string empty_string = "";
-const std::string dot = ".";
-const std::string double_dot = "..";
-const std::string colon = ":";
+// Internally all offsets are pointer sized so the _64 variants work on
+// buffers larger than 2**31. The int API is a thin wrapper on top of the
+// same implementations; its end = MAX_32BIT_INT default arg still limits
+// it to str sizes of 2**31.
+
+typedef std::ptrdiff_t Py_ssize_t;
+PYSTRING_INLINE const std::string forward_slash = "/";
+PYSTRING_INLINE const std::string double_forward_slash = "//";
+PYSTRING_INLINE const std::string triple_forward_slash = "///";
+PYSTRING_INLINE const std::string double_back_slash = "\\";
+PYSTRING_INLINE const std::string empty_string = "";
+PYSTRING_INLINE const std::string dot = ".";
+PYSTRING_INLINE const std::string double_dot = "..";
+PYSTRING_INLINE const std::string colon = ":";
 
 
 /* helper macro to fixup start/end slice values */
@@ -55,1629 +106,5593 @@ const std::string colon = ":";
     }
 
 
-	namespace {
+    namespace detail {
 
-		//////////////////////////////////////////////////////////////////////////////////////////////
-		/// why doesn't the std::reverse work?
-		///
-		void reverse_strings( std::vector< std::string > & result)
-		{
-			for (std::vector< std::string >::size_type i = 0; i < result.size() / 2; i++ )
-			{
-				std::swap(result[i], result[result.size() - 1 - i]);
-			}
-		}
-
-		//////////////////////////////////////////////////////////////////////////////////////////////
-		///
-		///
-		void split_whitespace( std::string_view str, std::vector< std::string > & result, int maxsplit )
-		{
-			std::string::size_type i, j, len = str.size();
-			for (i = j = 0; i < len; )
-			{
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Byte properties and case maps with the C locale's ASCII rules. Unlike the <cctype>
+        /// functions they do not depend on the global locale and are defined for every char,
+        /// including negative ones; bytes >= 0x80 have no properties and map to themselves.
+        ///
+        enum : unsigned char
+        {
+            ascii_space = 1,
+            ascii_digit = 2,
+            ascii_upper = 4,
+            ascii_lower = 8,
+            ascii_alpha = ascii_upper | ascii_lower,
+            ascii_alnum = ascii_alpha | ascii_digit
+        };
 
-				while ( i < len && ::isspace( str[i] ) ) i++;
-				j = i;
+        struct ascii_table
+        {
+            unsigned char flags[256];
+            char lower[256];
+            char upper[256];
+            char swapcase[256];
+        };
 
-				while ( i < len && ! ::isspace( str[i]) ) i++;
+        constexpr ascii_table make_ascii_table()
+        {
+            ascii_table table = {};
+            for ( int c = 0; c < 256; ++c )
+            {
+                int flags = 0;
+                if ( c == ' ' || ( c >= '\t' && c <= '\r' ) ) flags = ascii_space;
+                else if ( c >= '0' && c <= '9' ) flags = ascii_digit;
+                else if ( c >= 'A' && c <= 'Z' ) flags = ascii_upper;
+                else if ( c >= 'a' && c <= 'z' ) flags = ascii_lower;
+
+                int lower = flags == ascii_upper ? c + ( 'a' - 'A' ) : c;
+                int upper = flags == ascii_lower ? c - ( 'a' - 'A' ) : c;
+                table.flags[c] = (unsigned char) flags;
+                table.lower[c] = (char) lower;
+                table.upper[c] = (char) upper;
+                table.swapcase[c] = (char) ( flags == ascii_upper ? lower : upper );
+            }
+            return table;
+        }
 
+        PYSTRING_INLINE constexpr ascii_table ascii = make_ascii_table();
 
+        inline bool has_ascii_flags( char c, unsigned char flags )
+        {
+            return ( ascii.flags[(unsigned char) c] & flags ) != 0;
+        }
 
-				if (j < i)
-				{
-					if ( maxsplit-- <= 0 ) break;
+        inline bool is_space( char c ) { return has_ascii_flags( c, ascii_space ); }
+        inline bool is_digit( char c ) { return has_ascii_flags( c, ascii_digit ); }
+        inline bool is_upper( char c ) { return has_ascii_flags( c, ascii_upper ); }
+        inline bool is_lower( char c ) { return has_ascii_flags( c, ascii_lower ); }
+        inline bool is_alpha( char c ) { return has_ascii_flags( c, ascii_alpha ); }
+        inline bool is_alnum( char c ) { return has_ascii_flags( c, ascii_alnum ); }
+        inline char to_lower( char c ) { return ascii.lower[(unsigned char) c]; }
+        inline char to_upper( char c ) { return ascii.upper[(unsigned char) c]; }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Index of the lowest set bit of a non-zero mask.
+        ///
+        inline unsigned count_trailing_zeros( std::uint32_t mask )
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward( &index, mask );
+            return (unsigned) index;
+#else
+            return (unsigned) __builtin_ctz( mask );
+#endif
+        }
 
-					result.push_back(std::string( str.substr( j, i - j )));
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Index of the highest set bit of a non-zero mask.
+        ///
+        inline unsigned highest_bit_index( std::uint32_t mask )
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse( &index, mask );
+            return (unsigned) index;
+#else
+            return 31u - (unsigned) __builtin_clz( mask );
+#endif
+        }
 
-					while ( i < len && ::isspace( str[i])) i++;
-					j = i;
-				}
-			}
-			if (j < len)
-			{
-				result.push_back(std::string( str.substr( j, len - j )));
-			}
-		}
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// The byte kernels below come in scalar, SSE2 and AVX2 variants. The variants are bound
+        /// into a kernel_table once per process (see kernels()), and the plain names are wrappers
+        /// that call through the selected table. The AVX2 variants are compiled for that target
+        /// alone, so one binary runs on any x86-64 CPU.
+        ///
 
+#if defined(PYSTRING_HAVE_SSE2)
+        inline __m128i load_block( const char * s )
+        {
+            return _mm_loadu_si128( (const __m128i *) s );
+        }
+#endif
 
-		//////////////////////////////////////////////////////////////////////////////////////////////
-		///
-		///
-		void rsplit_whitespace( std::string_view str, std::vector< std::string > & result, int maxsplit )
-		{
-			std::string::size_type len = str.size();
-			std::string::size_type i, j;
-			for (i = j = len; i > 0; )
-			{
+#if defined(PYSTRING_HAVE_AVX2)
+        PYSTRING_TARGET_AVX2 inline __m256i load_block_avx2( const char * s )
+        {
+            return _mm256_loadu_si256( (const __m256i *) s );
+        }
+#endif
 
-				while ( i > 0 && ::isspace( str[i - 1] ) ) i--;
-				j = i;
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Length of the run of ASCII (< 0x80) bytes at the start of s. The scalar variant checks
+        /// 8 bytes at a time with a word mask.
+        ///
+        PYSTRING_INLINE std::size_t ascii_prefix_length_scalar( const char * s, std::size_t len )
+        {
+            std::size_t i = 0;
+            for ( ; i + 8 <= len; i += 8 )
+            {
+                std::uint64_t word;
+                std::memcpy( &word, s + i, 8 );
+                if ( word & 0x8080808080808080ULL ) break;
+            }
+            while ( i < len && !( s[i] & 0x80 ) ) ++i;
+            return i;
+        }
 
-				while ( i > 0 && ! ::isspace( str[i - 1]) ) i--;
+#if defined(PYSTRING_HAVE_SSE2)
+        PYSTRING_INLINE std::size_t ascii_prefix_length_sse2( const char * s, std::size_t len )
+        {
+            std::size_t i = 0;
+            for ( ; i + 16 <= len; i += 16 )
+            {
+                int mask = _mm_movemask_epi8( load_block( s + i ) );
+                if ( mask ) return i + count_trailing_zeros( (std::uint32_t) mask );
+            }
+            return i + ascii_prefix_length_scalar( s + i, len - i );
+        }
+#endif
 
+#if defined(PYSTRING_HAVE_AVX2)
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE std::size_t ascii_prefix_length_avx2( const char * s, std::size_t len )
+        {
+            std::size_t i = 0;
+            for ( ; i + 32 <= len; i += 32 )
+            {
+                std::uint32_t mask = (std::uint32_t) _mm256_movemask_epi8( load_block_avx2( s + i ) );
+                if ( mask ) return i + count_trailing_zeros( mask );
+            }
+            return i + ascii_prefix_length_scalar( s + i, len - i );
+        }
+#endif
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Inclusive byte ranges describing the character classes tested by the is* predicates.
+        /// byte_class numbers them for the kernel table.
+        ///
+        struct byte_range
+        {
+            unsigned char first, last;
+        };
 
-				if (j > i)
-				{
-					if ( maxsplit-- <= 0 ) break;
+        PYSTRING_INLINE constexpr byte_range space_class[] = { { '\t', '\r' }, { ' ', ' ' } };
+        PYSTRING_INLINE constexpr byte_range digit_class[] = { { '0', '9' } };
+        PYSTRING_INLINE constexpr byte_range upper_class[] = { { 'A', 'Z' } };
+        PYSTRING_INLINE constexpr byte_range lower_class[] = { { 'a', 'z' } };
+        PYSTRING_INLINE constexpr byte_range alpha_class[] = { { 'A', 'Z' }, { 'a', 'z' } };
+        PYSTRING_INLINE constexpr byte_range alnum_class[] = { { '0', '9' }, { 'A', 'Z' }, { 'a', 'z' } };
+        PYSTRING_INLINE constexpr byte_range ascii_class[] = { { 0x00, 0x7F } };
+        PYSTRING_INLINE constexpr byte_range printable_class[] = { { ' ', '~' } };
+        PYSTRING_INLINE constexpr byte_range identifier_class[] = { { '0', '9' }, { 'A', 'Z' }, { '_', '_' }, { 'a', 'z' } };
+
+        enum byte_class
+        {
+            space_chars, digit_chars, upper_chars, lower_chars, alpha_chars, alnum_chars,
+            ascii_chars, printable_chars, identifier_chars, byte_class_count
+        };
 
-					result.push_back(std::string(str.substr( i, j - i )));
+        template< std::size_t N >
+        inline bool byte_in_ranges( char c, const byte_range ( &ranges )[N] )
+        {
+            for ( const byte_range & r : ranges )
+            {
+                if ( (unsigned char) ( c - r.first ) <= (unsigned char) ( r.last - r.first ) ) return true;
+            }
+            return false;
+        }
 
-					while ( i > 0 && ::isspace( str[i - 1])) i--;
-					j = i;
-				}
-			}
-			if (j > 0)
-			{
-				result.push_back(std::string(str.substr( 0, j )));
-			}
-			//std::reverse( result, result.begin(), result.end() );
-			reverse_strings( result );
-		}
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// True if every byte of s is in one of the ranges (vacuously true for len == 0).
+        ///
+        template< std::size_t N >
+        bool all_in_ranges_scalar( const char * s, std::size_t len, const byte_range ( &ranges )[N] )
+        {
+            for ( std::size_t i = 0; i < len; ++i )
+            {
+                if ( !byte_in_ranges( s[i], ranges ) ) return false;
+            }
+            return true;
+        }
 
-	} //anonymous namespace
+#if defined(PYSTRING_HAVE_SSE2)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Lanes of v that fall in any of the ranges. Each range is one unsigned compare: biasing
+        /// by 0x80 - first moves [first, last] to the bottom of the signed range, so a single
+        /// signed less-than against the range width tests both bounds.
+        ///
+        template< std::size_t N >
+        inline __m128i in_ranges_block( __m128i v, const byte_range ( &ranges )[N] )
+        {
+            __m128i hit = _mm_setzero_si128();
+            for ( const byte_range & r : ranges )
+            {
+                int width = r.last - r.first + 1;
+                __m128i biased = _mm_add_epi8( v, _mm_set1_epi8( (char) ( 0x80 - r.first ) ) );
+                hit = _mm_or_si128( hit, _mm_cmplt_epi8( biased, _mm_set1_epi8( (char) ( width - 0x80 ) ) ) );
+            }
+            return hit;
+        }
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Checks 32 bytes per iteration, reducing both halves to a single all-lanes mask.
+        ///
+        template< std::size_t N >
+        bool all_in_ranges_sse2( const char * s, std::size_t len, const byte_range ( &ranges )[N] )
+        {
+            std::size_t i = 0;
+            for ( ; i + 32 <= len; i += 32 )
+            {
+                __m128i a = in_ranges_block( load_block( s + i ), ranges );
+                __m128i b = in_ranges_block( load_block( s + i + 16 ), ranges );
+                if ( _mm_movemask_epi8( _mm_and_si128( a, b ) ) != 0xFFFF ) return false;
+            }
+            if ( i + 16 <= len )
+            {
+                __m128i a = in_ranges_block( load_block( s + i ), ranges );
+                if ( _mm_movemask_epi8( a ) != 0xFFFF ) return false;
+                i += 16;
+            }
+            return all_in_ranges_scalar( s + i, len - i, ranges );
+        }
+#endif
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    void split( std::string_view str, std::vector< std::string > & result, std::string_view sep, int maxsplit )
-    {
-        result.clear();
+#if defined(PYSTRING_HAVE_AVX2)
+        template< std::size_t N >
+        PYSTRING_TARGET_AVX2 inline __m256i in_ranges_block_avx2( __m256i v, const byte_range ( &ranges )[N] )
+        {
+            __m256i hit = _mm256_setzero_si256();
+            for ( const byte_range & r : ranges )
+            {
+                int width = r.last - r.first + 1;
+                __m256i biased = _mm256_add_epi8( v, _mm256_set1_epi8( (char) ( 0x80 - r.first ) ) );
+                hit = _mm256_or_si256( hit, _mm256_cmpgt_epi8( _mm256_set1_epi8( (char) ( width - 0x80 ) ), biased ) );
+            }
+            return hit;
+        }
 
-        if ( maxsplit < 0 ) maxsplit = MAX_32BIT_INT;//result.max_size();
+        template< std::size_t N >
+        PYSTRING_TARGET_AVX2 bool all_in_ranges_avx2( const char * s, std::size_t len, const byte_range ( &ranges )[N] )
+        {
+            std::size_t i = 0;
+            for ( ; i + 64 <= len; i += 64 )
+            {
+                __m256i a = in_ranges_block_avx2( load_block_avx2( s + i ), ranges );
+                __m256i b = in_ranges_block_avx2( load_block_avx2( s + i + 32 ), ranges );
+                if ( (std::uint32_t) _mm256_movemask_epi8( _mm256_and_si256( a, b ) ) != 0xFFFFFFFFu ) return false;
+            }
+            if ( i + 32 <= len )
+            {
+                __m256i a = in_ranges_block_avx2( load_block_avx2( s + i ), ranges );
+                if ( (std::uint32_t) _mm256_movemask_epi8( a ) != 0xFFFFFFFFu ) return false;
+                i += 32;
+            }
+            return all_in_ranges_scalar( s + i, len - i, ranges );
+        }
+#endif
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// all_in_ranges variants bound to one class, for the kernel table.
+        ///
+        template< const auto & Ranges >
+        bool all_in_class_scalar( const char * s, std::size_t len ) { return all_in_ranges_scalar( s, len, Ranges ); }
+#if defined(PYSTRING_HAVE_SSE2)
+        template< const auto & Ranges >
+        bool all_in_class_sse2( const char * s, std::size_t len ) { return all_in_ranges_sse2( s, len, Ranges ); }
+#endif
+#if defined(PYSTRING_HAVE_AVX2)
+        template< const auto & Ranges >
+        PYSTRING_TARGET_AVX2 bool all_in_class_avx2( const char * s, std::size_t len ) { return all_in_ranges_avx2( s, len, Ranges ); }
+#endif
 
-        if ( sep.size() == 0 )
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// The istitle scan. A byte is cased if it is upper or lower case; uppercase bytes may only
+        /// follow uncased ones and lowercase bytes only cased ones. The vector variants take each
+        /// block's previous-is-cased flags from its cased mask shifted up one lane, carrying the
+        /// last lane over, and finish with the scalar scan from where they stopped.
+        ///
+        PYSTRING_INLINE bool title_bytes_from( const char * s, std::size_t i, std::size_t len, bool previous_is_cased, bool any_cased )
         {
-            split_whitespace( str, result, maxsplit );
-            return;
+            for ( ; i < len; ++i )
+            {
+                if ( is_upper( s[i] ) )
+                {
+                    if ( previous_is_cased ) return false;
+                    previous_is_cased = true;
+                    any_cased = true;
+                }
+                else if ( is_lower( s[i] ) )
+                {
+                    if ( !previous_is_cased ) return false;
+                    previous_is_cased = true;
+                    any_cased = true;
+                }
+                else
+                {
+                    previous_is_cased = false;
+                }
+            }
+            return any_cased;
         }
 
-        std::string::size_type i,j, len = str.size(), n = sep.size();
-
-        i = j = 0;
+        PYSTRING_INLINE bool title_bytes_scalar( const char * s, std::size_t len )
+        {
+            return title_bytes_from( s, 0, len, false, false );
+        }
 
-        while ( i+n <= len )
+#if defined(PYSTRING_HAVE_SSE2)
+        PYSTRING_INLINE bool title_bytes_sse2( const char * s, std::size_t len )
         {
-            if ( str[i] == sep[0] && str.substr( i, n ) == sep )
+            std::size_t i = 0;
+            std::uint32_t carry = 0, any_cased = 0;
+            for ( ; i + 16 <= len; i += 16 )
             {
-                if ( maxsplit-- <= 0 ) break;
-
-                result.push_back(std::string(str.substr( j, i - j )));
-                i = j = i + n;
+                __m128i v = load_block( s + i );
+                std::uint32_t upper = (std::uint32_t) _mm_movemask_epi8( in_ranges_block( v, upper_class ) );
+                std::uint32_t lower = (std::uint32_t) _mm_movemask_epi8( in_ranges_block( v, lower_class ) );
+                std::uint32_t cased = upper | lower;
+                std::uint32_t previous = ( ( cased << 1 ) | carry ) & 0xFFFF;
+                if ( ( upper & previous ) | ( lower & ~previous ) ) return false;
+                carry = cased >> 15;
+                any_cased |= cased;
             }
-            else
+            return title_bytes_from( s, i, len, carry != 0, any_cased != 0 );
+        }
+#endif
+
+#if defined(PYSTRING_HAVE_AVX2)
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE bool title_bytes_avx2( const char * s, std::size_t len )
+        {
+            std::size_t i = 0;
+            std::uint32_t carry = 0, any_cased = 0;
+            for ( ; i + 32 <= len; i += 32 )
             {
-                i++;
+                __m256i v = load_block_avx2( s + i );
+                std::uint32_t upper = (std::uint32_t) _mm256_movemask_epi8( in_ranges_block_avx2( v, upper_class ) );
+                std::uint32_t lower = (std::uint32_t) _mm256_movemask_epi8( in_ranges_block_avx2( v, lower_class ) );
+                std::uint32_t cased = upper | lower;
+                std::uint32_t previous = ( cased << 1 ) | carry;
+                if ( ( upper & previous ) | ( lower & ~previous ) ) return false;
+                carry = cased >> 31;
+                any_cased |= cased;
             }
+            return title_bytes_from( s, i, len, carry != 0, any_cased != 0 );
         }
+#endif
 
-        result.push_back(std::string(str.substr( j, len-j )));
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    void rsplit( std::string_view str, std::vector< std::string > & result, std::string_view sep, int maxsplit )
-    {
-        if ( maxsplit < 0 )
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// In-place byte case kernels shared by lower/upper/swapcase and the utf8 versions. The
+        /// vector variants flip bit 0x20 of the lanes in the class being mapped (upper case for
+        /// lower, lower case for upper, both for swapcase); the tail goes through the tables.
+        ///
+        PYSTRING_INLINE void map_bytes_scalar( char * s, std::size_t len, const char * table )
         {
-            split( str, result, sep, maxsplit );
-            return;
+            for ( std::size_t i = 0; i < len; ++i ) s[i] = table[(unsigned char) s[i]];
         }
 
-        result.clear();
+        PYSTRING_INLINE void lower_bytes_scalar( char * s, std::size_t len ) { map_bytes_scalar( s, len, ascii.lower ); }
+        PYSTRING_INLINE void upper_bytes_scalar( char * s, std::size_t len ) { map_bytes_scalar( s, len, ascii.upper ); }
+        PYSTRING_INLINE void swapcase_bytes_scalar( char * s, std::size_t len ) { map_bytes_scalar( s, len, ascii.swapcase ); }
 
-        if ( sep.size() == 0 )
+#if defined(PYSTRING_HAVE_SSE2)
+        template< std::size_t N >
+        void flip_case_sse2( char * s, std::size_t len, const byte_range ( &ranges )[N], const char * table )
         {
-            rsplit_whitespace( str, result, maxsplit );
-            return;
+            const __m128i bit = _mm_set1_epi8( 0x20 );
+            std::size_t i = 0;
+            for ( ; i + 16 <= len; i += 16 )
+            {
+                __m128i v = load_block( s + i );
+                _mm_storeu_si128( (__m128i *) (s + i), _mm_xor_si128( v, _mm_and_si128( in_ranges_block( v, ranges ), bit ) ) );
+            }
+            map_bytes_scalar( s + i, len - i, table );
         }
 
-        Py_ssize_t i,j, len = (Py_ssize_t) str.size(), n = (Py_ssize_t) sep.size();
+        PYSTRING_INLINE void lower_bytes_sse2( char * s, std::size_t len ) { flip_case_sse2( s, len, upper_class, ascii.lower ); }
+        PYSTRING_INLINE void upper_bytes_sse2( char * s, std::size_t len ) { flip_case_sse2( s, len, lower_class, ascii.upper ); }
+        PYSTRING_INLINE void swapcase_bytes_sse2( char * s, std::size_t len ) { flip_case_sse2( s, len, alpha_class, ascii.swapcase ); }
+#endif
+
+#if defined(PYSTRING_HAVE_AVX2)
+        template< std::size_t N >
+        PYSTRING_TARGET_AVX2 void flip_case_avx2( char * s, std::size_t len, const byte_range ( &ranges )[N], const char * table )
+        {
+            const __m256i bit = _mm256_set1_epi8( 0x20 );
+            std::size_t i = 0;
+            for ( ; i + 32 <= len; i += 32 )
+            {
+                __m256i v = load_block_avx2( s + i );
+                _mm256_storeu_si256( (__m256i *) (s + i), _mm256_xor_si256( v, _mm256_and_si256( in_ranges_block_avx2( v, ranges ), bit ) ) );
+            }
+            map_bytes_scalar( s + i, len - i, table );
+        }
 
-        i = j = len;
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE void lower_bytes_avx2( char * s, std::size_t len ) { flip_case_avx2( s, len, upper_class, ascii.lower ); }
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE void upper_bytes_avx2( char * s, std::size_t len ) { flip_case_avx2( s, len, lower_class, ascii.upper ); }
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE void swapcase_bytes_avx2( char * s, std::size_t len ) { flip_case_avx2( s, len, alpha_class, ascii.swapcase ); }
+#endif
 
-        while ( i >= n )
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Highest offset of c in s, or npos: memrchr. The vector variants compare 32 bytes per
+        /// step from the end.
+        ///
+        PYSTRING_INLINE std::size_t rfind_byte_scalar( const char * s, std::size_t len, char c )
         {
-            if ( str[i - 1] == sep[n - 1] && str.substr( i - n, n ) == sep )
+            while ( len > 0 )
             {
-                if ( maxsplit-- <= 0 ) break;
+                if ( s[--len] == c ) return len;
+            }
+            return std::string_view::npos;
+        }
 
-                result.push_back(std::string(str.substr( i, j - i )));
-                i = j = i - n;
+#if defined(PYSTRING_HAVE_SSE2)
+        PYSTRING_INLINE std::size_t rfind_byte_sse2( const char * s, std::size_t len, char c )
+        {
+            std::size_t end = len;
+            const __m128i v = _mm_set1_epi8( c );
+            for ( ; end >= 32; end -= 32 )
+            {
+                std::uint32_t low = (std::uint32_t) _mm_movemask_epi8( _mm_cmpeq_epi8( load_block( s + end - 32 ), v ) );
+                std::uint32_t high = (std::uint32_t) _mm_movemask_epi8( _mm_cmpeq_epi8( load_block( s + end - 16 ), v ) );
+                std::uint32_t mask = low | ( high << 16 );
+                if ( mask ) return end - 32 + highest_bit_index( mask );
             }
-            else
+            if ( end >= 16 )
             {
-                i--;
+                std::uint32_t mask = (std::uint32_t) _mm_movemask_epi8( _mm_cmpeq_epi8( load_block( s + end - 16 ), v ) );
+                if ( mask ) return end - 16 + highest_bit_index( mask );
+                end -= 16;
             }
+            return rfind_byte_scalar( s, end, c );
         }
+#endif
 
-        result.push_back(std::string(str.substr( 0, j )));
-        reverse_strings( result );
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    enum class string_strip_direction_ : std::uint8_t
-    {
-        leftstrip,
-        rightstrip,
-        bothstrip
-    };
+#if defined(PYSTRING_HAVE_AVX2)
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE std::size_t rfind_byte_avx2( const char * s, std::size_t len, char c )
+        {
+            std::size_t end = len;
+            const __m256i v = _mm256_set1_epi8( c );
+            for ( ; end >= 32; end -= 32 )
+            {
+                std::uint32_t mask = (std::uint32_t) _mm256_movemask_epi8( _mm256_cmpeq_epi8( load_block_avx2( s + end - 32 ), v ) );
+                if ( mask ) return end - 32 + highest_bit_index( mask );
+            }
+            return rfind_byte_scalar( s, end, c );
+        }
+#endif
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string do_strip( std::string_view str, string_strip_direction_ striptype, std::string_view chars  )
-    {
-        Py_ssize_t len = (Py_ssize_t) str.size(), i, j, charslen = (Py_ssize_t) chars.size();
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Number of bytes of s equal to c. The vector variants subtract each compare mask from
+        /// per-lane byte counters, summing them into the total with psadbw before they can wrap.
+        ///
+        PYSTRING_INLINE std::size_t count_byte_scalar( const char * s, std::size_t len, char c )
+        {
+            std::size_t total = 0;
+            for ( std::size_t i = 0; i < len; ++i ) total += s[i] == c;
+            return total;
+        }
 
-        if ( charslen == 0 )
+#if defined(PYSTRING_HAVE_SSE2)
+        PYSTRING_INLINE std::size_t count_byte_sse2( const char * s, std::size_t len, char c )
         {
-            i = 0;
-            if ( striptype != string_strip_direction_::rightstrip )
+            const __m128i v = _mm_set1_epi8( c );
+            std::size_t i = 0, total = 0;
+            while ( i + 16 <= len )
             {
-                while ( i < len && ::isspace( str[i] ) )
+                std::size_t blocks = std::min( ( len - i ) / 16, std::size_t( 255 ) );
+                __m128i counts = _mm_setzero_si128();
+                for ( std::size_t b = 0; b < blocks; ++b, i += 16 )
                 {
-                    i++;
+                    counts = _mm_sub_epi8( counts, _mm_cmpeq_epi8( load_block( s + i ), v ) );
                 }
+                __m128i sums = _mm_sad_epu8( counts, _mm_setzero_si128() );
+                total += (std::size_t) _mm_cvtsi128_si32( sums ) + (std::size_t) _mm_extract_epi16( sums, 4 );
             }
+            return total + count_byte_scalar( s + i, len - i, c );
+        }
+#endif
 
-            j = len;
-            if ( striptype != string_strip_direction_::leftstrip )
+#if defined(PYSTRING_HAVE_AVX2)
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE std::size_t count_byte_avx2( const char * s, std::size_t len, char c )
+        {
+            const __m256i v = _mm256_set1_epi8( c );
+            std::size_t i = 0, total = 0;
+            while ( i + 32 <= len )
             {
-                do
+                std::size_t blocks = std::min( ( len - i ) / 32, std::size_t( 255 ) );
+                __m256i counts = _mm256_setzero_si256();
+                for ( std::size_t b = 0; b < blocks; ++b, i += 32 )
                 {
-                    j--;
+                    counts = _mm256_sub_epi8( counts, _mm256_cmpeq_epi8( load_block_avx2( s + i ), v ) );
                 }
-                while (j >= i && ::isspace(str[j]));
-
-                j++;
+                __m256i sums = _mm256_sad_epu8( counts, _mm256_setzero_si256() );
+                __m128i half = _mm_add_epi64( _mm256_castsi256_si128( sums ), _mm256_extracti128_si256( sums, 1 ) );
+                total += (std::size_t) _mm_cvtsi128_si32( half ) + (std::size_t) _mm_extract_epi16( half, 4 );
             }
+            return total + count_byte_scalar( s + i, len - i, c );
+        }
+#endif
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// dst[i] = table[src[i]] for a 256 byte table. Every table binds the scalar loop: a
+        /// 16 row vpshufb lookup costs 64 vector ops per 32 bytes and measured no faster.
+        ///
+        PYSTRING_INLINE void translate_bytes_scalar( const char * src, char * dst, std::size_t len, const char * table )
+        {
+            for ( std::size_t i = 0; i < len; ++i ) dst[i] = table[(unsigned char) src[i]];
+        }
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Index of the first byte of s whose membership in set equals member, or len; with
+        /// member false this finds the first byte not in the set, which is what strip needs.
+        ///
+        PYSTRING_INLINE std::size_t find_membership_scalar( const char * s, std::size_t len, const CharSet & set, bool member )
+        {
+            std::size_t i = 0;
+            while ( i < len && set.contains( s[i] ) != member ) ++i;
+            return i;
         }
-        else
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Index of the last byte of s whose membership in set equals member, or npos.
+        ///
+        PYSTRING_INLINE std::size_t rfind_membership_scalar( const char * s, std::size_t len, const CharSet & set, bool member )
         {
-            const char * sep = chars.data();
+            while ( len > 0 )
+            {
+                if ( set.contains( s[--len] ) == member ) return len;
+            }
+            return std::string_view::npos;
+        }
 
-            i = 0;
-            if ( striptype != string_strip_direction_::rightstrip )
+#if defined(PYSTRING_HAVE_SSE2)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Mask of the lanes of block that are members of set. Sets of up to eight bytes are
+        /// matched with one compare per member; with SSSE3 any set is looked up with two nibble
+        /// shuffles of the set's nibble_rows. Returns -1 when neither applies.
+        ///
+        struct byte_set_kernel
+        {
+            __m128i members[8];
+            std::size_t count;
+#if defined(PYSTRING_HAVE_SSSE3)
+            __m128i rows_low, rows_high;
+#endif
+            bool usable;
+
+            explicit byte_set_kernel( const CharSet & set ) : count( set.size() ), usable( true )
             {
-                while ( i < len && memchr(sep, str[i], charslen) )
+                if ( count <= 8 )
                 {
-                    i++;
+                    for ( std::size_t k = 0; k < count; ++k ) members[k] = _mm_set1_epi8( (char) set.members()[k] );
+                    return;
                 }
+#if defined(PYSTRING_HAVE_SSSE3)
+                rows_low = _mm_loadu_si128( (const __m128i *) set.nibble_rows() );
+                rows_high = _mm_loadu_si128( (const __m128i *) ( set.nibble_rows() + 16 ) );
+#else
+                usable = false;
+#endif
             }
 
-            j = len;
-            if (striptype != string_strip_direction_::leftstrip)
+            int match( __m128i block ) const
             {
-                do
+                __m128i hit = _mm_setzero_si128();
+                if ( count <= 8 )
                 {
-                    j--;
+                    for ( std::size_t k = 0; k < count; ++k ) hit = _mm_or_si128( hit, _mm_cmpeq_epi8( block, members[k] ) );
+                    return _mm_movemask_epi8( hit );
                 }
-                while (j >= i &&  memchr(sep, str[j], charslen)  );
-                j++;
+#if defined(PYSTRING_HAVE_SSSE3)
+                const __m128i nibble = _mm_set1_epi8( 0x0f );
+                __m128i lo = _mm_and_si128( block, nibble );
+                __m128i hi = _mm_and_si128( _mm_srli_epi16( block, 4 ), nibble );
+                const __m128i bit_low = _mm_setr_epi8( 1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0 );
+                const __m128i bit_high = _mm_setr_epi8( 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128 );
+                hit = _mm_or_si128( _mm_and_si128( _mm_shuffle_epi8( rows_low, lo ), _mm_shuffle_epi8( bit_low, hi ) ),
+                                    _mm_and_si128( _mm_shuffle_epi8( rows_high, lo ), _mm_shuffle_epi8( bit_high, hi ) ) );
+                return _mm_movemask_epi8( _mm_cmpeq_epi8( hit, _mm_setzero_si128() ) ) ^ 0xffff;
+#else
+                (void) block;
+                return -1;
+#endif
             }
+        };
 
-
-        }
-
-        if ( i == 0 && j == len )
+        PYSTRING_INLINE std::size_t find_membership_sse2( const char * s, std::size_t len, const CharSet & set, bool member )
         {
-            return std::string(str);
-        }
-        else
-        {
-            return std::string(str.substr( i, j - i ));
+            std::size_t i = 0;
+            if ( len >= 16 )
+            {
+                byte_set_kernel kernel( set );
+                if ( kernel.usable )
+                {
+                    int flip = member ? 0 : 0xffff;
+                    for ( ; i + 16 <= len; i += 16 )
+                    {
+                        int mask = kernel.match( load_block( s + i ) ) ^ flip;
+                        if ( mask ) return i + count_trailing_zeros( (std::uint32_t) mask );
+                    }
+                }
+            }
+            return i + find_membership_scalar( s + i, len - i, set, member );
         }
 
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    void partition( std::string_view str, std::string_view sep, std::vector< std::string > & result )
-    {
-        result.resize(3);
-        int index = find( str, sep );
-        if ( index < 0 )
-        {
-            result[0] = str;
-            result[1] = empty_string;
-            result[2] = empty_string;
-        }
-        else
+        PYSTRING_INLINE std::size_t rfind_membership_sse2( const char * s, std::size_t len, const CharSet & set, bool member )
         {
-            result[0] = str.substr( 0, index );
-            result[1] = sep;
-            result[2] = str.substr( index + sep.size(), str.size() );
+            if ( len >= 16 )
+            {
+                byte_set_kernel kernel( set );
+                if ( kernel.usable )
+                {
+                    int flip = member ? 0 : 0xffff;
+                    for ( ; len >= 16; len -= 16 )
+                    {
+                        int mask = kernel.match( load_block( s + len - 16 ) ) ^ flip;
+                        if ( mask ) return len - 16 + highest_bit_index( (std::uint32_t) mask );
+                    }
+                }
+            }
+            return rfind_membership_scalar( s, len, set, member );
         }
-    }
+#endif
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    void rpartition( std::string_view str, std::string_view sep, std::vector< std::string > & result )
-    {
-        result.resize(3);
-        int index = rfind( str, sep );
-        if ( index < 0 )
-        {
-            result[0] = empty_string;
-            result[1] = empty_string;
-            result[2] = str;
-        }
-        else
+#if defined(PYSTRING_HAVE_AVX2)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// The 32 byte form of byte_set_kernel. vpshufb is part of AVX2, so the nibble lookup is
+        /// always available here and every set size is vectorized.
+        ///
+        struct byte_set_kernel_avx2
         {
-            result[0] = str.substr( 0, index );
-            result[1] = sep;
-            result[2] = str.substr( index + sep.size(), str.size() );
-        }
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string strip( std::string_view str, std::string_view chars )
-    {
-        return do_strip( str, string_strip_direction_::bothstrip, chars );
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string lstrip( std::string_view str, std::string_view chars )
-    {
-        return do_strip( str, string_strip_direction_::leftstrip, chars );
-    }
+            __m256i members[8];
+            __m256i rows_low, rows_high;
+            std::size_t count;
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string rstrip( std::string_view str, std::string_view chars )
-    {
-        return do_strip( str, string_strip_direction_::rightstrip, chars );
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string join( std::string_view str, const std::vector< std::string > & seq )
-    {
-        std::vector< std::string >::size_type seqlen = seq.size(), i;
-
-        if ( seqlen == 0 ) return empty_string;
-        if ( seqlen == 1 ) return seq[0];
+            PYSTRING_TARGET_AVX2 explicit byte_set_kernel_avx2( const CharSet & set ) : count( set.size() )
+            {
+                if ( count <= 8 )
+                {
+                    for ( std::size_t k = 0; k < count; ++k ) members[k] = _mm256_set1_epi8( (char) set.members()[k] );
+                    return;
+                }
+                rows_low = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *) set.nibble_rows() ) );
+                rows_high = _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *) ( set.nibble_rows() + 16 ) ) );
+            }
 
-        std::string result( seq[0] );
+            PYSTRING_TARGET_AVX2 std::uint32_t match( __m256i block ) const
+            {
+                __m256i hit = _mm256_setzero_si256();
+                if ( count <= 8 )
+                {
+                    for ( std::size_t k = 0; k < count; ++k ) hit = _mm256_or_si256( hit, _mm256_cmpeq_epi8( block, members[k] ) );
+                    return (std::uint32_t) _mm256_movemask_epi8( hit );
+                }
+                const __m256i nibble = _mm256_set1_epi8( 0x0f );
+                __m256i lo = _mm256_and_si256( block, nibble );
+                __m256i hi = _mm256_and_si256( _mm256_srli_epi16( block, 4 ), nibble );
+                const __m256i bit_low = _mm256_setr_epi8( 1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                          1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0 );
+                const __m256i bit_high = _mm256_setr_epi8( 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128,
+                                                           0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128 );
+                hit = _mm256_or_si256( _mm256_and_si256( _mm256_shuffle_epi8( rows_low, lo ), _mm256_shuffle_epi8( bit_low, hi ) ),
+                                       _mm256_and_si256( _mm256_shuffle_epi8( rows_high, lo ), _mm256_shuffle_epi8( bit_high, hi ) ) );
+                return ~(std::uint32_t) _mm256_movemask_epi8( _mm256_cmpeq_epi8( hit, _mm256_setzero_si256() ) );
+            }
+        };
 
-        for ( i = 1; i < seqlen; ++i )
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE std::size_t find_membership_avx2( const char * s, std::size_t len, const CharSet & set, bool member )
         {
-            result += std::string(str) + seq[i];
+            std::size_t i = 0;
+            if ( len >= 32 )
+            {
+                byte_set_kernel_avx2 kernel( set );
+                std::uint32_t flip = member ? 0u : ~0u;
+                for ( ; i + 32 <= len; i += 32 )
+                {
+                    std::uint32_t mask = kernel.match( load_block_avx2( s + i ) ) ^ flip;
+                    if ( mask ) return i + count_trailing_zeros( mask );
+                }
+            }
+            return i + find_membership_sse2( s + i, len - i, set, member );
+        }
 
+        PYSTRING_TARGET_AVX2 PYSTRING_INLINE std::size_t rfind_membership_avx2( const char * s, std::size_t len, const CharSet & set, bool member )
+        {
+            if ( len >= 32 )
+            {
+                byte_set_kernel_avx2 kernel( set );
+                std::uint32_t flip = member ? 0u : ~0u;
+                for ( ; len >= 32; len -= 32 )
+                {
+                    std::uint32_t mask = kernel.match( load_block_avx2( s + len - 32 ) ) ^ flip;
+                    if ( mask ) return len - 32 + highest_bit_index( mask );
+                }
+            }
+            return rfind_membership_sse2( s, len, set, member );
         }
+#endif
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// One variant of every dispatched kernel, all built for the same instruction set.
+        /// all_in is indexed by byte_class.
+        ///
+        struct kernel_table
+        {
+            isa level;
+            std::size_t ( *ascii_prefix_length )( const char * s, std::size_t len );
+            bool ( *all_in[byte_class_count] )( const char * s, std::size_t len );
+            bool ( *title_bytes )( const char * s, std::size_t len );
+            void ( *lower_bytes )( char * s, std::size_t len );
+            void ( *upper_bytes )( char * s, std::size_t len );
+            void ( *swapcase_bytes )( char * s, std::size_t len );
+            std::size_t ( *rfind_byte )( const char * s, std::size_t len, char c );
+            std::size_t ( *count_byte )( const char * s, std::size_t len, char c );
+            void ( *translate_bytes )( const char * src, char * dst, std::size_t len, const char * table );
+            std::size_t ( *find_membership )( const char * s, std::size_t len, const CharSet & set, bool member );
+            std::size_t ( *rfind_membership )( const char * s, std::size_t len, const CharSet & set, bool member );
+        };
 
-        return result;
-    }
+        PYSTRING_INLINE constexpr kernel_table scalar_kernels =
+        {
+            isa::scalar,
+            ascii_prefix_length_scalar,
+            { all_in_class_scalar< space_class >, all_in_class_scalar< digit_class >, all_in_class_scalar< upper_class >,
+              all_in_class_scalar< lower_class >, all_in_class_scalar< alpha_class >, all_in_class_scalar< alnum_class >,
+              all_in_class_scalar< ascii_class >, all_in_class_scalar< printable_class >, all_in_class_scalar< identifier_class > },
+            title_bytes_scalar,
+            lower_bytes_scalar, upper_bytes_scalar, swapcase_bytes_scalar,
+            rfind_byte_scalar,
+            count_byte_scalar,
+            translate_bytes_scalar,
+            find_membership_scalar, rfind_membership_scalar
+        };
 
+#if defined(PYSTRING_HAVE_SSE2)
+        PYSTRING_INLINE constexpr kernel_table sse2_kernels =
+        {
+            isa::sse2,
+            ascii_prefix_length_sse2,
+            { all_in_class_sse2< space_class >, all_in_class_sse2< digit_class >, all_in_class_sse2< upper_class >,
+              all_in_class_sse2< lower_class >, all_in_class_sse2< alpha_class >, all_in_class_sse2< alnum_class >,
+              all_in_class_sse2< ascii_class >, all_in_class_sse2< printable_class >, all_in_class_sse2< identifier_class > },
+            title_bytes_sse2,
+            lower_bytes_sse2, upper_bytes_sse2, swapcase_bytes_sse2,
+            rfind_byte_sse2,
+            count_byte_sse2,
+            translate_bytes_scalar,
+            find_membership_sse2, rfind_membership_sse2
+        };
+#endif
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    
-    namespace
-    {
-        enum class string_tailmatch_direction_ : std::uint8_t
+#if defined(PYSTRING_HAVE_AVX2)
+        PYSTRING_INLINE constexpr kernel_table avx2_kernels =
         {
-            startswith,
-            endswith
+            isa::avx2,
+            ascii_prefix_length_avx2,
+            { all_in_class_avx2< space_class >, all_in_class_avx2< digit_class >, all_in_class_avx2< upper_class >,
+              all_in_class_avx2< lower_class >, all_in_class_avx2< alpha_class >, all_in_class_avx2< alnum_class >,
+              all_in_class_avx2< ascii_class >, all_in_class_avx2< printable_class >, all_in_class_avx2< identifier_class > },
+            title_bytes_avx2,
+            lower_bytes_avx2, upper_bytes_avx2, swapcase_bytes_avx2,
+            rfind_byte_avx2,
+            count_byte_avx2,
+            translate_bytes_scalar,
+            find_membership_avx2, rfind_membership_avx2
         };
+#endif
 
-        /* Matches the end (direction >= 0) or start (direction < 0) of self
-         * against substr, using the start and end arguments. Returns
-         * -1 on error, 0 if not found and 1 if found.
-         */
-        bool _string_tailmatch(std::string_view self, std::string_view substr,
-                              Py_ssize_t start, Py_ssize_t end,
-                              string_tailmatch_direction_ direction)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// The best instruction set that is both built in and supported by this CPU.
+        ///
+        PYSTRING_INLINE isa best_isa()
         {
-            Py_ssize_t len = (Py_ssize_t) self.size();
-            Py_ssize_t slen = (Py_ssize_t) substr.size();
-            
-            const char* sub = substr.data();
-            const char* str = self.data();
-            
-            ADJUST_INDICES(start, end, len);
-            
-            if (direction == string_tailmatch_direction_::startswith) {
-                // startswith
-                if (start+slen > len)
-                    return false;
-            } else {
-                // endswith
-                if (end-start < slen || start > len)
-                    return false;
-                if (end-slen > start)
-                    start = end - slen;
+#if defined(PYSTRING_HAVE_AVX2)
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid( info, 0 );
+            if ( info[0] >= 7 )
+            {
+                // AVX2 also needs the OS to save the ymm registers (OSXSAVE, then XCR0 bits 1-2).
+                __cpuid( info, 1 );
+                bool os_saves_ymm = ( info[2] & ( 1 << 27 ) ) && ( info[2] & ( 1 << 28 ) ) && ( _xgetbv( 0 ) & 6 ) == 6;
+                __cpuidex( info, 7, 0 );
+                if ( os_saves_ymm && ( info[1] & ( 1 << 5 ) ) ) return isa::avx2;
             }
-            if (end-start >= slen)
-                return (!std::memcmp(str+start, sub, slen));
-            
-            return false;
+#else
+            __builtin_cpu_init();
+            if ( __builtin_cpu_supports( "avx2" ) ) return isa::avx2;
+#endif
+#endif
+#if defined(PYSTRING_HAVE_SSE2)
+            return isa::sse2;
+#else
+            return isa::scalar;
+#endif
         }
-    }
-    
-    bool endswith( std::string_view str, std::string_view suffix, int start, int end )
-    {
-        auto result = _string_tailmatch(str, suffix,
-                                       (Py_ssize_t) start, (Py_ssize_t) end,
-                                       string_tailmatch_direction_::endswith);
-        //if (result == -1) // TODO: Error condition
-        
-        return result;
-    }
-    
-    
-    bool startswith( std::string_view str, std::string_view prefix, int start, int end )
-    {
-        auto result = _string_tailmatch(str, prefix,
-                                       (Py_ssize_t) start, (Py_ssize_t) end,
-                                       string_tailmatch_direction_::startswith);
-        //if (result == -1) // TODO: Error condition
-        
-        return result;
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
 
-    bool isalnum( std::string_view str )
-    {
-        std::string::size_type len = str.size(), i;
-        if ( len == 0 ) return false;
+        PYSTRING_INLINE const kernel_table & kernels_for( isa level )
+        {
+            switch ( level )
+            {
+#if defined(PYSTRING_HAVE_AVX2)
+            case isa::avx2: return avx2_kernels;
+#endif
+#if defined(PYSTRING_HAVE_SSE2)
+            case isa::sse2: return sse2_kernels;
+#endif
+            default: return scalar_kernels;
+            }
+        }
 
+        PYSTRING_INLINE std::atomic< const kernel_table * > active_kernels( nullptr );
 
-        if( len == 1 )
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Bind the kernels on first use: the best supported instruction set, capped by
+        /// PYSTRING_FORCE_ISA if it names a lower one. A force_isa that got in first is kept.
+        ///
+        PYSTRING_INLINE const kernel_table & select_kernels()
         {
-            return ::isalnum( str[0] );
+            isa level = best_isa();
+            if ( const char * forced = std::getenv( "PYSTRING_FORCE_ISA" ) )
+            {
+                for ( isa candidate : { isa::scalar, isa::sse2, isa::avx2 } )
+                {
+                    const char * name = isa_name( candidate );
+                    std::size_t n = 0;
+                    while ( name[n] && to_lower( forced[n] ) == name[n] ) ++n;
+                    if ( !name[n] && !forced[n] && candidate < level ) level = candidate;
+                }
+            }
+
+            const kernel_table * expected = nullptr;
+            active_kernels.compare_exchange_strong( expected, &kernels_for( level ) );
+            return *active_kernels.load();
         }
 
-        for ( i = 0; i < len; ++i )
+        inline const kernel_table & kernels()
         {
-            if ( !::isalnum( str[i] ) ) return false;
+            const kernel_table * table = active_kernels.load( std::memory_order_acquire );
+            return table ? *table : select_kernels();
         }
-        return true;
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    bool isalpha( std::string_view str )
-    {
-        std::string::size_type len = str.size(), i;
-        if ( len == 0 ) return false;
-        if( len == 1 ) return ::isalpha( (int) str[0] );
 
-        for ( i = 0; i < len; ++i )
+#if defined(PYSTRING_HAVE_SSE2)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Whether the kernels written directly against baseline SSE2 may use it; false when the
+        /// scalar kernels are forced, so those run their scalar loops too.
+        ///
+        inline bool use_sse2()
         {
-           if ( !::isalpha( (int) str[i] ) ) return false;
+            return kernels().level != isa::scalar;
         }
-        return true;
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    bool isdigit( std::string_view str )
-    {
-        std::string::size_type len = str.size(), i;
-        if ( len == 0 ) return false;
-        if( len == 1 ) return ::isdigit( str[0] );
+#endif
 
-        for ( i = 0; i < len; ++i )
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Dispatching wrappers, under the names the rest of the file uses.
+        ///
+        inline std::size_t ascii_prefix_length( const char * s, std::size_t len ) { return kernels().ascii_prefix_length( s, len ); }
+        inline bool all_in_class( const char * s, std::size_t len, byte_class c ) { return kernels().all_in[c]( s, len ); }
+        inline bool title_bytes( const char * s, std::size_t len ) { return kernels().title_bytes( s, len ); }
+        inline void lower_bytes( char * s, std::size_t len ) { kernels().lower_bytes( s, len ); }
+        inline void upper_bytes( char * s, std::size_t len ) { kernels().upper_bytes( s, len ); }
+        inline void swapcase_bytes( char * s, std::size_t len ) { kernels().swapcase_bytes( s, len ); }
+        inline std::size_t rfind_byte( const char * s, std::size_t len, char c ) { return kernels().rfind_byte( s, len, c ); }
+        inline std::size_t count_byte( const char * s, std::size_t len, char c ) { return kernels().count_byte( s, len, c ); }
+        inline void translate_bytes( const char * src, char * dst, std::size_t len, const char * table ) { kernels().translate_bytes( src, dst, len, table ); }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Set searches: the first or last byte of s that is (in_set) or is not (not_in_set) a
+        /// member of set, len or npos if there is none. The not_in_set forms probe the first
+        /// byte before dispatching, since strip usually stops there.
+        ///
+        inline std::size_t find_in_set( const char * s, std::size_t len, const CharSet & set )
         {
-           if ( ! ::isdigit( str[i] ) ) return false;
+            return set.empty() ? len : kernels().find_membership( s, len, set, true );
         }
-        return true;
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    bool islower( std::string_view str )
-    {
-        std::string::size_type len = str.size(), i;
-        if ( len == 0 ) return false;
-        if( len == 1 ) return ::islower( str[0] );
 
-        for ( i = 0; i < len; ++i )
+        inline std::size_t rfind_in_set( const char * s, std::size_t len, const CharSet & set )
         {
-           if ( !::islower( str[i] ) ) return false;
+            return set.empty() ? std::string_view::npos : kernels().rfind_membership( s, len, set, true );
         }
-        return true;
-    }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    bool isspace( std::string_view str )
-    {
-        std::string::size_type len = str.size(), i;
-        if ( len == 0 ) return false;
-        if( len == 1 ) return ::isspace( str[0] );
 
-        for ( i = 0; i < len; ++i )
+        inline std::size_t find_not_in_set( const char * s, std::size_t len, const CharSet & set )
         {
-           if ( !::isspace( str[i] ) ) return false;
+            if ( len == 0 || !set.contains( s[0] ) ) return 0;
+            return kernels().find_membership( s, len, set, false );
         }
-        return true;
-    }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    bool istitle( std::string_view str )
-    {
-        std::string::size_type len = str.size(), i;
+        inline std::size_t rfind_not_in_set( const char * s, std::size_t len, const CharSet & set )
+        {
+            if ( len == 0 ) return std::string_view::npos;
+            if ( !set.contains( s[len - 1] ) ) return len - 1;
+            return kernels().rfind_membership( s, len, set, false );
+        }
 
-        if ( len == 0 ) return false;
-        if ( len == 1 ) return ::isupper( str[0] );
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// ASCII case folding used by the case-insensitive functions: 'A'..'Z' map to 'a'..'z',
+        /// every other byte (including non-ASCII) compares as itself.
+        ///
+        inline unsigned char fold_ascii( char c )
+        {
+            unsigned char u = (unsigned char) c;
+            return (unsigned char) ( u - 'A' ) < 26u ? (unsigned char) ( u | 0x20 ) : u;
+        }
 
-        bool cased = false, previous_is_cased = false;
+#if defined(PYSTRING_HAVE_SSE2)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Fold 16 bytes at once: OR 0x20 into the lanes holding 'A'..'Z'. Bytes >= 0x80 are
+        /// negative as signed chars, so they fail the lower bound and are left alone.
+        ///
+        inline __m128i fold_ascii_block( __m128i v )
+        {
+            __m128i upper = _mm_and_si128( _mm_cmpgt_epi8( v, _mm_set1_epi8( 'A' - 1 ) ),
+                                           _mm_cmplt_epi8( v, _mm_set1_epi8( 'Z' + 1 ) ) );
+            return _mm_or_si128( v, _mm_and_si128( upper, _mm_set1_epi8( 0x20 ) ) );
+        }
+#endif
 
-        for ( i = 0; i < len; ++i )
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Compare n bytes ignoring ASCII case. Returns the difference of the first pair of
+        /// folded bytes that differ, or 0 if the ranges are equal.
+        ///
+        PYSTRING_INLINE int icompare_bytes( const char * a, const char * b, std::size_t n )
         {
-            if ( ::isupper( str[i] ) )
+            std::size_t i = 0;
+#if defined(PYSTRING_HAVE_SSE2)
+            if ( n >= 16 && use_sse2() )
             {
-                if ( previous_is_cased )
+                for ( ; i + 16 <= n; i += 16 )
                 {
-                    return false;
+                    __m128i eq = _mm_cmpeq_epi8( fold_ascii_block( load_block( a + i ) ),
+                                                 fold_ascii_block( load_block( b + i ) ) );
+                    int mask = _mm_movemask_epi8( eq ) ^ 0xFFFF;
+                    if ( mask )
+                    {
+                        i += count_trailing_zeros( (std::uint32_t) mask );
+                        return (int) fold_ascii( a[i] ) - (int) fold_ascii( b[i] );
+                    }
                 }
-
-                previous_is_cased = true;
-                cased = true;
             }
-            else if ( ::islower( str[i] ) )
+#endif
+            for ( ; i < n; ++i )
+            {
+                int d = (int) fold_ascii( a[i] ) - (int) fold_ascii( b[i] );
+                if ( d ) return d;
+            }
+            return 0;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Lowest offset of needle in hay ignoring ASCII case, or npos. Blocks of 16 candidate
+        /// positions are filtered on the folded first and last needle bytes before the full
+        /// comparison.
+        ///
+        PYSTRING_INLINE std::size_t ifind_bytes( const char * hay, std::size_t hlen, const char * needle, std::size_t nlen )
+        {
+            if ( nlen == 0 ) return 0;
+            if ( nlen > hlen ) return std::string_view::npos;
+
+            const std::size_t last = hlen - nlen; // last possible match position
+            const unsigned char first_c = fold_ascii( needle[0] ), last_c = fold_ascii( needle[nlen - 1] );
+            std::size_t i = 0;
+
+#if defined(PYSTRING_HAVE_SSE2)
+            if ( use_sse2() )
             {
-                if (!previous_is_cased)
+                const __m128i vfirst = _mm_set1_epi8( (char) first_c ), vlast = _mm_set1_epi8( (char) last_c );
+                for ( ; i + 15 <= last; i += 16 )
                 {
-                    return false;
+                    __m128i f = _mm_cmpeq_epi8( fold_ascii_block( load_block( hay + i ) ), vfirst );
+                    __m128i l = _mm_cmpeq_epi8( fold_ascii_block( load_block( hay + i + nlen - 1 ) ), vlast );
+                    std::uint32_t mask = (std::uint32_t) _mm_movemask_epi8( _mm_and_si128( f, l ) );
+                    while ( mask )
+                    {
+                        std::size_t pos = i + count_trailing_zeros( mask );
+                        if ( icompare_bytes( hay + pos, needle, nlen ) == 0 ) return pos;
+                        mask &= mask - 1;
+                    }
                 }
+            }
+#endif
+            for ( ; i <= last; ++i )
+            {
+                if ( fold_ascii( hay[i] ) == first_c && icompare_bytes( hay + i, needle, nlen ) == 0 ) return i;
+            }
+            return std::string_view::npos;
+        }
 
-                previous_is_cased = true;
-                cased = true;
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Highest offset of needle in hay ignoring ASCII case, or npos. Same filtering as
+        /// ifind_bytes, walking the blocks from the end.
+        ///
+        PYSTRING_INLINE std::size_t irfind_bytes( const char * hay, std::size_t hlen, const char * needle, std::size_t nlen )
+        {
+            if ( nlen == 0 ) return hlen;
+            if ( nlen > hlen ) return std::string_view::npos;
 
+            const unsigned char first_c = fold_ascii( needle[0] ), last_c = fold_ascii( needle[nlen - 1] );
+            std::size_t end = hlen - nlen + 1; // candidate positions are [0, end)
+
+#if defined(PYSTRING_HAVE_SSE2)
+            if ( use_sse2() )
+            {
+                const __m128i vfirst = _mm_set1_epi8( (char) first_c ), vlast = _mm_set1_epi8( (char) last_c );
+                for ( ; end >= 16; end -= 16 )
+                {
+                    std::size_t i = end - 16;
+                    __m128i f = _mm_cmpeq_epi8( fold_ascii_block( load_block( hay + i ) ), vfirst );
+                    __m128i l = _mm_cmpeq_epi8( fold_ascii_block( load_block( hay + i + nlen - 1 ) ), vlast );
+                    std::uint32_t mask = (std::uint32_t) _mm_movemask_epi8( _mm_and_si128( f, l ) );
+                    while ( mask )
+                    {
+                        unsigned bit = highest_bit_index( mask );
+                        if ( icompare_bytes( hay + i + bit, needle, nlen ) == 0 ) return i + bit;
+                        mask &= ~( 1u << bit );
+                    }
+                }
             }
-            else
+#endif
+            while ( end > 0 )
             {
-                previous_is_cased = false;
+                --end;
+                if ( fold_ascii( hay[end] ) == first_c && icompare_bytes( hay + end, needle, nlen ) == 0 ) return end;
             }
+            return std::string_view::npos;
         }
 
-        return cased;
-    }
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Highest offset of needle in hay, or npos; an empty needle matches at hlen. Blocks of
+        /// 16 candidate positions, walked from the end, are filtered on the first and last
+        /// needle bytes before the remaining bytes are compared.
+        ///
+        PYSTRING_INLINE std::size_t rfind_bytes( const char * hay, std::size_t hlen, const char * needle, std::size_t nlen )
+        {
+            if ( nlen == 0 ) return hlen;
+            if ( nlen > hlen ) return std::string_view::npos;
+            if ( nlen == 1 ) return rfind_byte( hay, hlen, needle[0] );
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    bool isupper( std::string_view str )
+            std::size_t end = hlen - nlen + 1; // candidate positions are [0, end)
+
+#if defined(PYSTRING_HAVE_SSE2)
+            if ( use_sse2() )
+            {
+                const __m128i vfirst = _mm_set1_epi8( needle[0] ), vlast = _mm_set1_epi8( needle[nlen - 1] );
+                for ( ; end >= 16; end -= 16 )
+                {
+                    std::size_t i = end - 16;
+                    __m128i f = _mm_cmpeq_epi8( load_block( hay + i ), vfirst );
+                    __m128i l = _mm_cmpeq_epi8( load_block( hay + i + nlen - 1 ), vlast );
+                    std::uint32_t mask = (std::uint32_t) _mm_movemask_epi8( _mm_and_si128( f, l ) );
+                    while ( mask )
+                    {
+                        unsigned bit = highest_bit_index( mask );
+                        if ( memcmp( hay + i + bit + 1, needle + 1, nlen - 2 ) == 0 ) return i + bit;
+                        mask &= ~( 1u << bit );
+                    }
+                }
+            }
+#endif
+            while ( end > 0 )
+            {
+                --end;
+                if ( hay[end] == needle[0] && hay[end + nlen - 1] == needle[nlen - 1] &&
+                     memcmp( hay + end + 1, needle + 1, nlen - 2 ) == 0 ) return end;
+            }
+            return std::string_view::npos;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// rpartition_view on the rfind_bytes kernel, for callers outside constant expressions.
+        ///
+        PYSTRING_INLINE partition_result rpartition_bytes( std::string_view str, std::string_view sep )
+        {
+            std::size_t index = rfind_bytes( str.data(), str.size(), sep.data(), sep.size() );
+            if ( index == std::string_view::npos ) return { std::string_view(), std::string_view(), str };
+            return { str.substr( 0, index ), str.substr( index, sep.size() ), str.substr( index + sep.size() ) };
+        }
+
+    } // namespace detail
+
+
+	namespace detail {
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// why doesn't the std::reverse work?
+		///
+		PYSTRING_INLINE void reverse_strings( std::vector< std::string > & result)
+		{
+			for (std::vector< std::string >::size_type i = 0; i < result.size() / 2; i++ )
+			{
+				std::swap(result[i], result[result.size() - 1 - i]);
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// The split cores hand each field to emit, which returns false to stop early, so the
+		/// same loops fill vectors of strings, small vectors of views and fixed size arrays.
+		///
+		template< typename Emit >
+		void split_whitespace( std::string_view str, int maxsplit, Emit emit )
+		{
+			std::string::size_type i, j, len = str.size();
+			for (i = j = 0; i < len; )
+			{
+
+				while ( i < len && is_space( str[i] ) ) i++;
+				j = i;
+
+				while ( i < len && ! is_space( str[i]) ) i++;
+
+
+
+				if (j < i)
+				{
+					if ( maxsplit-- <= 0 ) break;
+
+					if ( !emit( str.substr( j, i - j ) ) ) return;
+
+					while ( i < len && is_space( str[i])) i++;
+					j = i;
+				}
+			}
+			if (j < len)
+			{
+				emit( str.substr( j, len - j ) );
+			}
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// Emits the fields from last to first.
+		///
+		template< typename Emit >
+		void rsplit_whitespace( std::string_view str, int maxsplit, Emit emit )
+		{
+			std::string::size_type len = str.size();
+			std::string::size_type i, j;
+			for (i = j = len; i > 0; )
+			{
+
+				while ( i > 0 && is_space( str[i - 1] ) ) i--;
+				j = i;
+
+				while ( i > 0 && ! is_space( str[i - 1]) ) i--;
+
+
+
+				if (j > i)
+				{
+					if ( maxsplit-- <= 0 ) break;
+
+					if ( !emit( str.substr( i, j - i ) ) ) return;
+
+					while ( i > 0 && is_space( str[i - 1])) i--;
+					j = i;
+				}
+			}
+			if (j > 0)
+			{
+				emit( str.substr( 0, j ) );
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		///
+		///
+		template< typename Emit >
+		void split_fields( std::string_view str, std::string_view sep, int maxsplit, Emit emit )
+		{
+			if ( maxsplit < 0 ) maxsplit = MAX_32BIT_INT;//result.max_size();
+
+
+			if ( sep.size() == 0 )
+			{
+				split_whitespace( str, maxsplit, emit );
+				return;
+			}
+
+			std::string::size_type i,j, len = str.size(), n = sep.size();
+
+			i = j = 0;
+
+			while ( i+n <= len )
+			{
+				if ( str[i] == sep[0] && str.substr( i, n ) == sep )
+				{
+					if ( maxsplit-- <= 0 ) break;
+
+					if ( !emit( str.substr( j, i - j ) ) ) return;
+					i = j = i + n;
+				}
+				else
+				{
+					i++;
+				}
+			}
+
+			emit( str.substr( j, len-j ) );
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// Emits the fields from last to first; maxsplit must be >= 0.
+		///
+		template< typename Emit >
+		void rsplit_fields( std::string_view str, std::string_view sep, int maxsplit, Emit emit )
+		{
+			if ( sep.size() == 0 )
+			{
+				rsplit_whitespace( str, maxsplit, emit );
+				return;
+			}
+
+			std::string::size_type i, j = str.size(), n = sep.size();
+
+			while ( maxsplit-- > 0 )
+			{
+				i = rfind_bytes( str.data(), j, sep.data(), n );
+				if ( i == std::string_view::npos ) break;
+
+				if ( !emit( str.substr( i + n, j - i - n ) ) ) return;
+				j = i;
+			}
+
+			emit( str.substr( 0, j ) );
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// split_any: any member of set separates fields. With collapse, runs of separators
+		/// count as one and leading and trailing ones are ignored, as split_whitespace does.
+		///
+		template< typename Emit >
+		void split_any_fields( std::string_view str, const CharSet & set, int maxsplit, bool collapse, Emit emit )
+		{
+			if ( maxsplit < 0 ) maxsplit = MAX_32BIT_INT;
+
+			std::string::size_type i, j, len = str.size();
+
+			if ( !collapse )
+			{
+				for ( j = 0; maxsplit-- > 0; j = i + 1 )
+				{
+					i = j + find_in_set( str.data() + j, len - j, set );
+					if ( i == len ) break;
+					emit( str.substr( j, i - j ) );
+				}
+				emit( str.substr( j ) );
+				return;
+			}
+
+			for (i = j = 0; i < len; )
+			{
+				while ( i < len && set.contains( str[i] ) ) i++;
+				j = i;
+
+				i = j + find_in_set( str.data() + j, len - j, set );
+
+				if (j < i)
+				{
+					if ( maxsplit-- <= 0 ) break;
+
+					emit( str.substr( j, i - j ) );
+
+					while ( i < len && set.contains( str[i] ) ) i++;
+					j = i;
+				}
+			}
+			if (j < len)
+			{
+				emit( str.substr( j, len - j ) );
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// Emits the fields from last to first; maxsplit must be >= 0.
+		///
+		template< typename Emit >
+		void rsplit_any_fields( std::string_view str, const CharSet & set, int maxsplit, bool collapse, Emit emit )
+		{
+			std::string::size_type i, j, len = str.size();
+
+			if ( !collapse )
+			{
+				for ( j = len; maxsplit-- > 0; j = i )
+				{
+					i = rfind_in_set( str.data(), j, set );
+					if ( i == std::string_view::npos ) break;
+					emit( str.substr( i + 1, j - i - 1 ) );
+				}
+				emit( str.substr( 0, j ) );
+				return;
+			}
+
+			for (i = j = len; i > 0; )
+			{
+				while ( i > 0 && set.contains( str[i - 1] ) ) i--;
+				j = i;
+
+				std::string::size_type k = rfind_in_set( str.data(), j, set );
+				i = k == std::string_view::npos ? 0 : k + 1;
+
+				if (j > i)
+				{
+					if ( maxsplit-- <= 0 ) break;
+
+					emit( str.substr( i, j - i ) );
+
+					while ( i > 0 && set.contains( str[i - 1] ) ) i--;
+					j = i;
+				}
+			}
+			if (j > 0)
+			{
+				emit( str.substr( 0, j ) );
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		///
+		///
+		template< typename Emit >
+		void splitlines_fields( std::string_view str, bool keepends, Emit emit )
+		{
+			std::string::size_type len = str.size(), i, j, eol;
+
+			for (i = j = 0; i < len; )
+			{
+				while (i < len && str[i] != '\n' && str[i] != '\r') i++;
+
+				eol = i;
+				if (i < len)
+				{
+					if (str[i] == '\r' && i + 1 < len && str[i+1] == '\n')
+					{
+						i += 2;
+					}
+					else
+					{
+						i++;
+					}
+					if (keepends)
+					eol = i;
+
+				}
+
+				if ( !emit( str.substr( j, eol - j ) ) ) return;
+				j = i;
+
+			}
+
+			if (j < len)
+			{
+				emit( str.substr( j, len - j ) );
+			}
+		}
+
+		//////////////////////////////////////////////////////////////////////////////////////////////
+		/// Store field as result[i], reusing the string already there if there is one.
+		///
+		PYSTRING_INLINE void assign_field( std::vector< std::string > & result, std::size_t i, std::string_view field )
+		{
+			if ( i < result.size() )
+			{
+				result[i].assign( field.data(), field.size() );
+			}
+			else
+			{
+				result.emplace_back( field );
+			}
+		}
+
+	} // namespace detail
+
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void split( std::string_view str, std::vector< std::string > & result, std::string_view sep, int maxsplit )
+    {
+        result.clear();
+        detail::split_fields( str, sep, maxsplit, [&result]( std::string_view field )
+        {
+            result.push_back( std::string( field ) );
+            return true;
+        } );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void rsplit( std::string_view str, std::vector< std::string > & result, std::string_view sep, int maxsplit )
+    {
+        if ( maxsplit < 0 )
+        {
+            split( str, result, sep, maxsplit );
+            return;
+        }
+
+        result.clear();
+        detail::rsplit_fields( str, sep, maxsplit, [&result]( std::string_view field )
+        {
+            result.push_back( std::string( field ) );
+            return true;
+        } );
+        detail::reverse_strings( result );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void split_reuse( std::string_view str, std::vector< std::string > & result, std::string_view sep, int maxsplit )
+    {
+        std::size_t count = 0;
+        detail::split_fields( str, sep, maxsplit, [&]( std::string_view field )
+        {
+            detail::assign_field( result, count++, field );
+            return true;
+        } );
+        result.resize( count );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void split_any( std::string_view str, std::vector< std::string > & result, const CharSet & chars, int maxsplit, bool collapse )
+    {
+        result.clear();
+        detail::split_any_fields( str, chars, maxsplit, collapse, [&result]( std::string_view field )
+        {
+            result.push_back( std::string( field ) );
+        } );
+    }
+
+    PYSTRING_INLINE void split_any( std::string_view str, std::vector< std::string > & result, std::string_view chars, int maxsplit, bool collapse )
+    {
+        split_any( str, result, CharSet( chars ), maxsplit, collapse );
+    }
+
+    PYSTRING_INLINE void rsplit_any( std::string_view str, std::vector< std::string > & result, const CharSet & chars, int maxsplit, bool collapse )
+    {
+        if ( maxsplit < 0 )
+        {
+            split_any( str, result, chars, maxsplit, collapse );
+            return;
+        }
+
+        result.clear();
+        detail::rsplit_any_fields( str, chars, maxsplit, collapse, [&result]( std::string_view field )
+        {
+            result.push_back( std::string( field ) );
+        } );
+        detail::reverse_strings( result );
+    }
+
+    PYSTRING_INLINE void rsplit_any( std::string_view str, std::vector< std::string > & result, std::string_view chars, int maxsplit, bool collapse )
+    {
+        rsplit_any( str, result, CharSet( chars ), maxsplit, collapse );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void split_view( std::string_view str, small_vector_base< std::string_view > & result, std::string_view sep, int maxsplit )
+    {
+        result.clear();
+        detail::split_fields( str, sep, maxsplit, [&result]( std::string_view field )
+        {
+            result.push_back( field );
+            return true;
+        } );
+    }
+
+    PYSTRING_INLINE split_result split_view( std::string_view str, std::string_view * result, std::size_t capacity, std::string_view sep, int maxsplit )
+    {
+        split_result written = { 0, false };
+        detail::split_fields( str, sep, maxsplit, [&]( std::string_view field )
+        {
+            if ( written.count == capacity )
+            {
+                written.truncated = true;
+                return false;
+            }
+            result[written.count++] = field;
+            return true;
+        } );
+        return written;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void rsplit_view( std::string_view str, small_vector_base< std::string_view > & result, std::string_view sep, int maxsplit )
+    {
+        if ( maxsplit < 0 )
+        {
+            split_view( str, result, sep, maxsplit );
+            return;
+        }
+
+        result.clear();
+        detail::rsplit_fields( str, sep, maxsplit, [&result]( std::string_view field )
+        {
+            result.push_back( field );
+            return true;
+        } );
+        std::reverse( result.begin(), result.end() );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void rsplit_reuse( std::string_view str, std::vector< std::string > & result, std::string_view sep, int maxsplit )
+    {
+        // Collect the views first so each field lands in the string that held the field at
+        // the same position last time.
+        small_vector< std::string_view, 16 > fields;
+        rsplit_view( str, fields, sep, maxsplit );
+
+        for ( std::size_t i = 0; i < fields.size(); ++i ) detail::assign_field( result, i, fields[i] );
+        result.resize( fields.size() );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    enum class string_strip_direction_ : std::uint8_t
+    {
+        leftstrip,
+        rightstrip,
+        bothstrip
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string_view do_strip_view( std::string_view str, string_strip_direction_ striptype, const CharSet & chars )
+    {
+        std::size_t i = 0, j = str.size();
+
+        if ( striptype != string_strip_direction_::rightstrip )
+        {
+            i = detail::find_not_in_set( str.data(), j, chars );
+        }
+
+        if ( striptype != string_strip_direction_::leftstrip && i < j )
+        {
+            std::size_t k = detail::rfind_not_in_set( str.data() + i, j - i, chars );
+            j = k == std::string_view::npos ? i : i + k + 1;
+        }
+
+        return str.substr( i, j - i );
+    }
+
+    PYSTRING_INLINE std::string_view do_strip_view( std::string_view str, string_strip_direction_ striptype, std::string_view chars  )
+    {
+        Py_ssize_t len = (Py_ssize_t) str.size(), i, j, charslen = (Py_ssize_t) chars.size();
+
+        if ( charslen == 0 )
+        {
+            i = 0;
+            if ( striptype != string_strip_direction_::rightstrip )
+            {
+                while ( i < len && detail::is_space( str[i] ) )
+                {
+                    i++;
+                }
+            }
+
+            j = len;
+            if ( striptype != string_strip_direction_::leftstrip )
+            {
+                do
+                {
+                    j--;
+                }
+                while (j >= i && detail::is_space( str[j]));
+
+                j++;
+            }
+
+
+        }
+        else
+        {
+            return do_strip_view( str, striptype, CharSet( chars ) );
+        }
+
+        return str.substr( i, j - i );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void partition( std::string_view str, std::string_view sep, std::vector< std::string > & result )
+    {
+        partition_result parts = partition_view( str, sep );
+        result.resize(3);
+        result[0] = parts.head;
+        result[1] = parts.sep;
+        result[2] = parts.tail;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void rpartition( std::string_view str, std::string_view sep, std::vector< std::string > & result )
+    {
+        partition_result parts = detail::rpartition_bytes( str, sep );
+        result.resize(3);
+        result[0] = parts.head;
+        result[1] = parts.sep;
+        result[2] = parts.tail;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void partition_view( std::string_view str, std::string_view sep, small_vector_base< std::string_view > & result )
+    {
+        partition_result parts = partition_view( str, sep );
+        result.resize( 3 );
+        result[0] = parts.head;
+        result[1] = parts.sep;
+        result[2] = parts.tail;
+    }
+
+    PYSTRING_INLINE void rpartition_view( std::string_view str, std::string_view sep, small_vector_base< std::string_view > & result )
+    {
+        partition_result parts = detail::rpartition_bytes( str, sep );
+        result.resize( 3 );
+        result[0] = parts.head;
+        result[1] = parts.sep;
+        result[2] = parts.tail;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string_view strip_view( std::string_view str, std::string_view chars )
+    {
+        return do_strip_view( str, string_strip_direction_::bothstrip, chars );
+    }
+
+    PYSTRING_INLINE std::string_view lstrip_view( std::string_view str, std::string_view chars )
+    {
+        return do_strip_view( str, string_strip_direction_::leftstrip, chars );
+    }
+
+    PYSTRING_INLINE std::string_view rstrip_view( std::string_view str, std::string_view chars )
+    {
+        return do_strip_view( str, string_strip_direction_::rightstrip, chars );
+    }
+
+    PYSTRING_INLINE std::string_view strip_view( std::string_view str, const CharSet & chars )
+    {
+        return do_strip_view( str, string_strip_direction_::bothstrip, chars );
+    }
+
+    PYSTRING_INLINE std::string_view lstrip_view( std::string_view str, const CharSet & chars )
+    {
+        return do_strip_view( str, string_strip_direction_::leftstrip, chars );
+    }
+
+    PYSTRING_INLINE std::string_view rstrip_view( std::string_view str, const CharSet & chars )
+    {
+        return do_strip_view( str, string_strip_direction_::rightstrip, chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string strip( std::string_view str, std::string_view chars )
+    {
+        return std::string( strip_view( str, chars ) );
+    }
+
+    PYSTRING_INLINE std::string strip( std::string_view str, const CharSet & chars )
+    {
+        return std::string( strip_view( str, chars ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string lstrip( std::string_view str, std::string_view chars )
+    {
+        return std::string( lstrip_view( str, chars ) );
+    }
+
+    PYSTRING_INLINE std::string lstrip( std::string_view str, const CharSet & chars )
+    {
+        return std::string( lstrip_view( str, chars ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string rstrip( std::string_view str, std::string_view chars )
+    {
+        return std::string( rstrip_view( str, chars ) );
+    }
+
+    PYSTRING_INLINE std::string rstrip( std::string_view str, const CharSet & chars )
+    {
+        return std::string( rstrip_view( str, chars ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string join( std::string_view str, const std::vector< std::string > & seq )
+    {
+        std::vector< std::string >::size_type seqlen = seq.size(), i;
+
+        if ( seqlen == 0 ) return empty_string;
+        if ( seqlen == 1 ) return seq[0];
+
+        std::string result( seq[0] );
+
+        for ( i = 1; i < seqlen; ++i )
+        {
+            result += std::string(str) + seq[i];
+
+        }
+
+
+        return result;
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    
+    namespace detail
+    {
+        enum class string_tailmatch_direction_ : std::uint8_t
+        {
+            startswith,
+            endswith
+        };
+
+        /* Matches the end (direction >= 0) or start (direction < 0) of self
+         * against substr, using the start and end arguments. Returns
+         * -1 on error, 0 if not found and 1 if found.
+         */
+        PYSTRING_INLINE bool _string_tailmatch(std::string_view self, std::string_view substr,
+                              Py_ssize_t start, Py_ssize_t end,
+                              string_tailmatch_direction_ direction,
+                              bool ignore_case = false)
+        {
+            Py_ssize_t len = (Py_ssize_t) self.size();
+            Py_ssize_t slen = (Py_ssize_t) substr.size();
+            
+            const char* sub = substr.data();
+            const char* str = self.data();
+            
+            ADJUST_INDICES(start, end, len);
+            
+            if (direction == string_tailmatch_direction_::startswith) {
+                // startswith
+                if (start+slen > len)
+                    return false;
+            } else {
+                // endswith
+                if (end-start < slen || start > len)
+                    return false;
+                if (end-slen > start)
+                    start = end - slen;
+            }
+            if (end-start >= slen)
+            {
+                if (ignore_case)
+                    return (!icompare_bytes(str+start, sub, slen));
+                return (!std::memcmp(str+start, sub, slen));
+            }
+            
+            return false;
+        }
+    }
+    
+    PYSTRING_INLINE bool endswith_64( std::string_view str, std::string_view suffix, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        auto result = detail::_string_tailmatch(str, suffix,
+                                       (Py_ssize_t) start, (Py_ssize_t) end,
+                                       detail::string_tailmatch_direction_::endswith);
+        //if (result == -1) // TODO: Error condition
+        
+        return result;
+    }
+    
+    
+    PYSTRING_INLINE bool startswith_64( std::string_view str, std::string_view prefix, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        auto result = detail::_string_tailmatch(str, prefix,
+                                       (Py_ssize_t) start, (Py_ssize_t) end,
+                                       detail::string_tailmatch_direction_::startswith);
+        //if (result == -1) // TODO: Error condition
+        
+        return result;
+    }
+
+    PYSTRING_INLINE bool endswith( std::string_view str, std::string_view suffix, int start, int end )
+    {
+        return endswith_64( str, suffix, start, end );
+    }
+
+    PYSTRING_INLINE bool startswith( std::string_view str, std::string_view prefix, int start, int end )
+    {
+        return startswith_64( str, prefix, start, end );
+    }
+
+    PYSTRING_INLINE bool iendswith( std::string_view str, std::string_view suffix, int start, int end )
+    {
+        return detail::_string_tailmatch(str, suffix, (Py_ssize_t) start, (Py_ssize_t) end,
+                                 detail::string_tailmatch_direction_::endswith, true);
+    }
+
+    PYSTRING_INLINE bool istartswith( std::string_view str, std::string_view prefix, int start, int end )
+    {
+        return detail::_string_tailmatch(str, prefix, (Py_ssize_t) start, (Py_ssize_t) end,
+                                 detail::string_tailmatch_direction_::startswith, true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isalnum( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::alnum_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isalpha( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::alpha_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isascii( std::string_view str )
+    {
+        return detail::all_in_class( str.data(), str.size(), detail::ascii_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isdecimal( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::digit_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isdigit( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::digit_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isidentifier( std::string_view str )
+    {
+        if ( str.empty() || !( detail::is_alpha( str[0] ) || str[0] == '_' ) ) return false;
+        return detail::all_in_class( str.data() + 1, str.size() - 1, detail::identifier_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool islower( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::lower_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isprintable( std::string_view str )
+    {
+        return detail::all_in_class( str.data(), str.size(), detail::printable_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isspace( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::space_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool istitle( std::string_view str )
+    {
+        return detail::title_bytes( str.data(), str.size() );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isupper( std::string_view str )
+    {
+        return !str.empty() && detail::all_in_class( str.data(), str.size(), detail::upper_chars );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string capitalize( std::string_view str )
+    {
+        std::string s( str );
+        std::string::size_type len = s.size(), i;
+
+        if ( len > 0)
+        {
+            s[0] = detail::to_upper( s[0] );
+        }
+
+        for ( i = 1; i < len; ++i )
+        {
+            s[i] = detail::to_lower( s[i] );
+        }
+
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string lower( std::string_view str )
+    {
+        std::string s( str );
+        detail::lower_bytes( &s[0], s.size() );
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string upper( std::string_view str )
+    {
+        std::string s( str ) ;
+        detail::upper_bytes( &s[0], s.size() );
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string swapcase( std::string_view str )
+    {
+        std::string s( str );
+        detail::swapcase_bytes( &s[0], s.size() );
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string title( std::string_view str )
+    {
+        std::string s( str );
+        std::string::size_type len = s.size(), i;
+        bool previous_is_cased = false;
+
+        for ( i = 0; i < len; ++i )
+        {
+            char c = s[i];
+            if ( detail::is_lower(c) )
+            {
+                if ( !previous_is_cased )
+                {
+                    s[i] = detail::to_upper(c);
+                }
+                previous_is_cased = true;
+            }
+            else if ( detail::is_upper(c) )
+            {
+                if ( previous_is_cased )
+                {
+                    s[i] = detail::to_lower(c);
+                }
+                previous_is_cased = true;
+            }
+            else
+            {
+                previous_is_cased = false;
+            }
+        }
+
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string translate( std::string_view str, std::string_view table, const CharSet & deletechars )
+    {
+        std::string s;
+        std::string::size_type len = str.size();
+
+        if ( table.size() != 256 )
+        {
+            // TODO : raise exception instead
+            return std::string(str);
+        }
+
+        //if nothing is deleted, use faster code
+        if ( deletechars.empty() )
+        {
+            s.resize( len );
+            detail::translate_bytes( str.data(), &s[0], len, table.data() );
+            return s;
+        }
+
+        // Translate each run of kept bytes in one go, skipping the deleted runs between them.
+        s.resize( len );
+        std::string::size_type out = 0, i = 0;
+        while ( i < len )
+        {
+            std::string::size_type run = detail::find_in_set( str.data() + i, len - i, deletechars );
+            detail::translate_bytes( str.data() + i, &s[out], run, table.data() );
+            out += run;
+            i += run;
+            if ( i < len ) i += detail::find_not_in_set( str.data() + i, len - i, deletechars );
+        }
+        s.resize( out );
+
+        return s;
+
+    }
+
+    PYSTRING_INLINE std::string translate( std::string_view str, std::string_view table, std::string_view deletechars )
+    {
+        return translate( str, table, CharSet( deletechars ) );
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string zfill( std::string_view str, int width )
+    {
+        int len = (int)str.size();
+
+        if ( len >= width )
+        {
+            return std::string(str);
+        }
+
+        std::string s( str );
+
+        int fill = width - len;
+
+        s = std::string( fill, '0' ) + s;
+
+
+        if ( s[fill] == '+' || s[fill] == '-' )
+        {
+            s[0] = s[fill];
+            s[fill] = '0';
+        }
+
+        return s;
+
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string ljust( std::string_view str, int width )
+    {
+        std::string::size_type len = str.size();
+        if ( (( int ) len ) >= width ) return std::string(str);
+        return std::string(str) + std::string( width - len, ' ' );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string rjust( std::string_view str, int width )
+    {
+        std::string::size_type len = str.size();
+        if ( (( int ) len ) >= width ) return std::string(str);
+        return std::string( width - len, ' ' ) + std::string(str);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string center( std::string_view str, int width )
+    {
+        int len = (int) str.size();
+        int marg, left;
+
+        if ( len >= width ) return std::string(str);
+
+        marg = width - len;
+        left = marg / 2 + (marg & width & 1);
+
+        return std::string( left, ' ' ) + std::string(str) + std::string( marg - left, ' ' );
+
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string_view slice_view_64( std::string_view str, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        ADJUST_INDICES(start, end, (Py_ssize_t) str.size());
+        if ( start >= end ) return std::string_view();
+        return str.substr( start, end - start );
+    }
+
+    PYSTRING_INLINE std::string_view slice_view( std::string_view str, int start, int end )
+    {
+        return slice_view_64( str, start, end );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string slice_64( std::string_view str, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        return std::string( slice_view_64( str, start, end ) );
+    }
+
+    PYSTRING_INLINE std::string slice( std::string_view str, int start, int end )
+    {
+        return std::string( slice_view_64( str, start, end ) );
+    }
+    
+    
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::ptrdiff_t find_64( std::string_view str, std::string_view sub, std::ptrdiff_t start, std::ptrdiff_t end  )
+    {
+        ADJUST_INDICES(start, end, (Py_ssize_t) str.size());
+        
+        // Search only up to end, so a bounded find over a huge buffer stays bounded.
+        if ( start > end ) return -1;
+        
+        std::string::size_type result = str.substr( 0, (std::size_t) end ).find( sub, (std::size_t) start );
+        if ( result == std::string::npos ) return -1;
+        
+        return (Py_ssize_t) result;
+    }
+
+    PYSTRING_INLINE int find( std::string_view str, std::string_view sub, int start, int end  )
+    {
+        return (int) find_64( str, sub, start, end );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::ptrdiff_t index_64( std::string_view str, std::string_view sub, std::ptrdiff_t start, std::ptrdiff_t end  )
+    {
+        return find_64( str, sub, start, end );
+    }
+
+    PYSTRING_INLINE int index( std::string_view str, std::string_view sub, int start, int end  )
+    {
+        return find( str, sub, start, end );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::ptrdiff_t rfind_64( std::string_view str, std::string_view sub, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        ADJUST_INDICES(start, end, (Py_ssize_t) str.size());
+        
+        // Search backwards from the last position where sub still fits before end, so a
+        // match straddling end does not hide an earlier one.
+        if ( end - start < (Py_ssize_t) sub.size() ) return -1;
+        
+        std::size_t result = detail::rfind_bytes( str.data() + start, (std::size_t) ( end - start ), sub.data(), sub.size() );
+        if ( result == std::string_view::npos ) return -1;
+
+        return start + (Py_ssize_t) result;
+    }
+
+    PYSTRING_INLINE int rfind( std::string_view str, std::string_view sub, int start, int end )
+    {
+        return (int) rfind_64( str, sub, start, end );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::ptrdiff_t rindex_64( std::string_view str, std::string_view sub, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        return rfind_64( str, sub, start, end );
+    }
+
+    PYSTRING_INLINE int rindex( std::string_view str, std::string_view sub, int start, int end )
+    {
+        return rfind( str, sub, start, end );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string expandtabs( std::string_view str, int tabsize )
+    {
+        std::string s( str );
+
+        std::string::size_type len = str.size(), i = 0;
+        int offset = 0;
+
+        int j = 0;
+
+        for ( i = 0; i < len; ++i )
+        {
+            if ( str[i] == '\t' )
+            {
+
+                if ( tabsize > 0 )
+                {
+                    int fillsize = tabsize - (j % tabsize);
+                    j += fillsize;
+                    s.replace( i + offset, 1, std::string( fillsize, ' ' ));
+                    offset += fillsize - 1;
+                }
+                else
+                {
+                    s.replace( i + offset, 1, empty_string );
+                    offset -= 1;
+                }
+
+            }
+            else
+            {
+                j++;
+
+                if (str[i] == '\n' || str[i] == '\r')
+                {
+                    j = 0;
+                }
+            }
+        }
+
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::ptrdiff_t count_64( std::string_view str, std::string_view substr, std::ptrdiff_t start, std::ptrdiff_t end )
+    {
+        ADJUST_INDICES(start, end, (Py_ssize_t) str.size());
+        if ( start > end ) return 0;
+
+        // As in python, the empty string matches at every position from start to end.
+        if ( substr.empty() ) return end - start + 1;
+
+        if ( substr.size() == 1 )
+        {
+            return (Py_ssize_t) detail::count_byte( str.data() + start, (std::size_t) ( end - start ), substr[0] );
+        }
+
+        std::string_view window = str.substr( 0, (std::size_t) end );
+        Py_ssize_t nummatches = 0;
+        std::string::size_type cursor = (std::size_t) start;
+
+        while ( ( cursor = window.find( substr, cursor ) ) != std::string_view::npos )
+        {
+            cursor += substr.size();
+            nummatches += 1;
+        }
+
+        return nummatches;
+    }
+
+    PYSTRING_INLINE int count( std::string_view str, std::string_view substr, int start, int end )
+    {
+        return (int) count_64( str, substr, start, end );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE int ifind( std::string_view str, std::string_view sub, int start, int end )
+    {
+        Py_ssize_t s = start, e = end;
+        ADJUST_INDICES(s, e, (Py_ssize_t) str.size());
+        if ( e - s < (Py_ssize_t) sub.size() ) return -1;
+
+        std::size_t result = detail::ifind_bytes( str.data() + s, (std::size_t) (e - s), sub.data(), sub.size() );
+        return result == std::string_view::npos ? -1 : (int) ( s + (Py_ssize_t) result );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE int irfind( std::string_view str, std::string_view sub, int start, int end )
+    {
+        Py_ssize_t s = start, e = end;
+        ADJUST_INDICES(s, e, (Py_ssize_t) str.size());
+        if ( e - s < (Py_ssize_t) sub.size() ) return -1;
+
+        std::size_t result = detail::irfind_bytes( str.data() + s, (std::size_t) (e - s), sub.data(), sub.size() );
+        return result == std::string_view::npos ? -1 : (int) ( s + (Py_ssize_t) result );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE int icount( std::string_view str, std::string_view substr, int start, int end )
+    {
+        Py_ssize_t s = start, e = end;
+        ADJUST_INDICES(s, e, (Py_ssize_t) str.size());
+        if ( e - s < (Py_ssize_t) substr.size() ) return 0;
+        if ( substr.empty() ) return (int) ( e - s + 1 );
+
+        int nummatches = 0;
+        const char * cursor = str.data() + s, * stop = str.data() + e;
+
+        while ( 1 )
+        {
+            std::size_t result = detail::ifind_bytes( cursor, (std::size_t) (stop - cursor), substr.data(), substr.size() );
+            if ( result == std::string_view::npos ) break;
+
+            cursor += result + substr.size();
+            nummatches += 1;
+        }
+
+        return nummatches;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE int icompare( std::string_view a, std::string_view b )
+    {
+        int result = detail::icompare_bytes( a.data(), b.data(), std::min( a.size(), b.size() ) );
+        if ( result == 0 )
+        {
+            if ( a.size() == b.size() ) return 0;
+            return a.size() < b.size() ? -1 : 1;
+        }
+        return result < 0 ? -1 : 1;
+    }
+
+    namespace detail
+    {
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// The pieces of replace( str, oldstr, newstr, count ) in order, passed to emit as views
+        /// of str and newstr. An empty oldstr matches before every character and at the end.
+        ///
+        template< typename Emit >
+        void replace_pieces( std::string_view str, std::string_view oldstr, std::string_view newstr, int count, Emit emit )
+        {
+            std::size_t limit = count < 0 ? std::string_view::npos : (std::size_t) count;
+            std::size_t done = 0, pos = 0;
+
+            if ( oldstr.empty() )
+            {
+                for ( ; pos < str.size() && done < limit; ++pos, ++done )
+                {
+                    emit( newstr );
+                    emit( str.substr( pos, 1 ) );
+                }
+                if ( done < limit ) emit( newstr );
+                emit( str.substr( pos ) );
+                return;
+            }
+
+            while ( done < limit )
+            {
+                std::size_t hit = str.find( oldstr, pos );
+                if ( hit == std::string_view::npos ) break;
+                emit( str.substr( pos, hit - pos ) );
+                emit( newstr );
+                pos = hit + oldstr.size();
+                ++done;
+            }
+            emit( str.substr( pos ) );
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    
+    PYSTRING_INLINE std::string replace( std::string_view str, std::string_view oldstr, std::string_view newstr, int count )
+    {
+        int sofar = 0;
+        Py_ssize_t cursor = 0;
+        std::string s( str );
+
+        std::string::size_type oldlen = oldstr.size(), newlen = newstr.size();
+        
+        cursor = find_64( s, oldstr, cursor );
+
+        while ( cursor != -1 && cursor <= (Py_ssize_t)s.size() )
+        {
+            if ( count > -1 && sofar >= count )
+            {
+                break;
+            }
+
+            s.replace( cursor, oldlen, newstr );
+            cursor += (Py_ssize_t) newlen;
+
+            if ( oldlen != 0)
+            {
+                cursor = find_64( s, oldstr, cursor );
+            }
+            else
+            {
+                ++cursor;
+            }
+
+            ++sofar;
+        }
+
+        return s;
+
+    }
+    
+    
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void splitlines(  std::string_view str, std::vector< std::string > & result, bool keepends )
+    {
+        result.clear();
+        detail::splitlines_fields( str, keepends, [&result]( std::string_view line )
+        {
+            result.push_back( std::string( line ) );
+            return true;
+        } );
+    }
+
+    PYSTRING_INLINE void splitlines_reuse(  std::string_view str, std::vector< std::string > & result, bool keepends )
+    {
+        std::size_t count = 0;
+        detail::splitlines_fields( str, keepends, [&]( std::string_view line )
+        {
+            detail::assign_field( result, count++, line );
+            return true;
+        } );
+        result.resize( count );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string mul( std::string_view str, int n )
+    {
+        // Early exits
+        if (n <= 0) return empty_string;
+        if (n == 1) return std::string(str);
+        
+        std::ostringstream os;
+        for(int i=0; i<n; ++i)
+        {
+            os << str;
+        }
+        return os.str();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string_view removeprefix_view( std::string_view str, std::string_view prefix )
+    {
+        if ( str.substr( 0, prefix.size() ) == prefix )
+        {
+            return str.substr( prefix.size() );
+        }
+
+        return str;
+    }
+
+    PYSTRING_INLINE std::string removeprefix( std::string_view str, std::string_view prefix )
+    {
+        return std::string( removeprefix_view( str, prefix ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string_view removesuffix_view( std::string_view str, std::string_view suffix )
+    {
+        if ( str.size() >= suffix.size() && str.substr( str.size() - suffix.size() ) == suffix )
+        {
+            return str.substr( 0, str.size() - suffix.size() );
+        }
+
+        return str;
+    }
+
+    PYSTRING_INLINE std::string removesuffix( std::string_view str, std::string_view suffix )
+    {
+        return std::string( removesuffix_view( str, suffix ) );
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    namespace detail
+    {
+        // os.path.normcase for nt: ASCII lowercase, and '/' is the same as '\\'.
+        inline unsigned char normcase_nt_char( char c )
+        {
+            unsigned char u = fold_ascii( c );
+            return u == '/' ? (unsigned char) '\\' : u;
+        }
+
+        inline bool set_contains( const std::uint64_t * bits, unsigned char c )
+        {
+            return ( bits[c >> 6] >> ( c & 63 ) ) & 1;
+        }
+
+        inline void set_insert( std::uint64_t * bits, unsigned char c )
+        {
+            bits[c >> 6] |= std::uint64_t( 1 ) << ( c & 63 );
+        }
+    }
+
+    PYSTRING_INLINE CompiledPattern::CompiledPattern( std::string_view pattern, bool normcase_nt )
+        : m_anchor_start( pattern.empty() || pattern[0] != '*' ),
+          m_anchor_end( pattern.empty() || pattern[pattern.size() - 1] != '*' ),
+          m_normcase_nt( normcase_nt )
+    {
+        std::string folded;
+        if ( m_normcase_nt )
+        {
+            folded.reserve( pattern.size() );
+            for ( char c : pattern ) folded += (char) detail::normcase_nt_char( c );
+            pattern = folded;
+        }
+
+        std::size_t i = 0, n = pattern.size();
+        Segment segment = { 0, 0, 0, std::string::npos, 0 };
+
+        auto close_segment = [&]()
+        {
+            if ( segment.count ) m_segments.push_back( segment );
+            segment = { m_tokens.size(), 0, 0, std::string::npos, 0 };
+        };
+
+        auto add_literal = [&]( char c )
+        {
+            if ( segment.count && m_tokens.back().kind == TokenKind::literal )
+            {
+                m_tokens.back().length += 1;
+            }
+            else
+            {
+                if ( segment.search == std::string::npos )
+                {
+                    segment.search = m_tokens.size();
+                    segment.search_offset = segment.width;
+                }
+                m_tokens.push_back( { TokenKind::literal, (std::uint32_t) m_literals.size(), 1 } );
+                segment.count += 1;
+            }
+            m_literals += c;
+            segment.width += 1;
+        };
+
+        while ( i < n )
+        {
+            char c = pattern[i++];
+
+            if ( c == '*' )
+            {
+                while ( i < n && pattern[i] == '*' ) ++i;
+                close_segment();
+            }
+            else if ( c == '?' )
+            {
+                m_tokens.push_back( { TokenKind::any, 0, 1 } );
+                segment.count += 1;
+                segment.width += 1;
+            }
+            else if ( c == '[' )
+            {
+                std::size_t j = i;
+                if ( j < n && pattern[j] == '!' ) ++j;
+                if ( j < n && pattern[j] == ']' ) ++j;
+                while ( j < n && pattern[j] != ']' ) ++j;
+
+                if ( j >= n )
+                {
+                    // No closing bracket: '[' is an ordinary character.
+                    add_literal( c );
+                    continue;
+                }
+
+                bool negate = pattern[i] == '!';
+                std::size_t k = negate ? i + 1 : i;
+
+                std::uint64_t bits[4] = { 0, 0, 0, 0 };
+                while ( k < j )
+                {
+                    unsigned char lo = (unsigned char) pattern[k];
+                    if ( k + 2 < j && pattern[k + 1] == '-' )
+                    {
+                        // Reversed ranges such as z-a are empty, as in python.
+                        unsigned char hi = (unsigned char) pattern[k + 2];
+                        for ( unsigned int x = lo; x <= hi; ++x ) detail::set_insert( bits, (unsigned char) x );
+                        k += 3;
+                    }
+                    else
+                    {
+                        detail::set_insert( bits, lo );
+                        k += 1;
+                    }
+                }
+
+                if ( negate )
+                {
+                    for ( std::uint64_t & word : bits ) word = ~word;
+                }
+
+                m_tokens.push_back( { TokenKind::set, (std::uint32_t) ( m_sets.size() / 4 ), 1 } );
+                m_sets.insert( m_sets.end(), bits, bits + 4 );
+                segment.count += 1;
+                segment.width += 1;
+                i = j + 1;
+            }
+            else
+            {
+                add_literal( c );
+            }
+        }
+
+        close_segment();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// Test segment against the segment.width characters at name.
+    ///
+    PYSTRING_INLINE bool CompiledPattern::match_segment( const Segment & segment, const char * name ) const
+    {
+        for ( std::size_t t = segment.first; t < segment.first + segment.count; ++t )
+        {
+            const Token & token = m_tokens[t];
+
+            switch ( token.kind )
+            {
+                case TokenKind::literal:
+                {
+                    const char * literal = m_literals.data() + token.offset;
+                    if ( m_normcase_nt )
+                    {
+                        for ( std::uint32_t k = 0; k < token.length; ++k )
+                        {
+                            if ( detail::normcase_nt_char( name[k] ) != (unsigned char) literal[k] ) return false;
+                        }
+                    }
+                    else if ( std::memcmp( name, literal, token.length ) != 0 )
+                    {
+                        return false;
+                    }
+                    break;
+                }
+                case TokenKind::any:
+                    break;
+                case TokenKind::set:
+                {
+                    unsigned char c = m_normcase_nt ? detail::normcase_nt_char( *name ) : (unsigned char) *name;
+                    if ( !detail::set_contains( &m_sets[4 * token.offset], c ) ) return false;
+                    break;
+                }
+            }
+
+            name += token.length;
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// Leftmost position >= pos where segment matches name, or npos.
+    ///
+    PYSTRING_INLINE std::size_t CompiledPattern::find_segment( const Segment & segment, std::string_view name, std::size_t pos ) const
+    {
+        if ( name.size() < segment.width ) return std::string::npos;
+        const std::size_t last = name.size() - segment.width;
+
+        if ( segment.search == std::string::npos )
+        {
+            // Only '?' and sets: every position is a candidate.
+            for ( ; pos <= last; ++pos )
+            {
+                if ( match_segment( segment, name.data() + pos ) ) return pos;
+            }
+            return std::string::npos;
+        }
+
+        // Locate candidates with a substring search for the segment's first literal run. In
+        // nt mode the pattern was folded at compile time, so a case-insensitive search is
+        // exact unless the run contains a separator.
+        const Token & token = m_tokens[segment.search];
+        std::string_view literal( m_literals.data() + token.offset, token.length );
+        const bool plain_search = !m_normcase_nt || literal.find( '\\' ) == std::string_view::npos;
+
+        while ( pos <= last )
+        {
+            std::size_t from = pos + segment.search_offset;
+            std::size_t hit;
+
+            if ( !m_normcase_nt )
+            {
+                hit = name.find( literal, from );
+            }
+            else if ( plain_search )
+            {
+                hit = detail::ifind_bytes( name.data() + from, name.size() - from, literal.data(), literal.size() );
+                if ( hit != std::string::npos ) hit += from;
+            }
+            else
+            {
+                hit = from;
+                while ( hit + literal.size() <= name.size() )
+                {
+                    std::size_t k = 0;
+                    while ( k < literal.size() && detail::normcase_nt_char( name[hit + k] ) == (unsigned char) literal[k] ) ++k;
+                    if ( k == literal.size() ) break;
+                    ++hit;
+                }
+                if ( hit + literal.size() > name.size() ) hit = std::string::npos;
+            }
+
+            if ( hit == std::string::npos ) return std::string::npos;
+
+            std::size_t candidate = hit - segment.search_offset;
+            if ( candidate > last ) return std::string::npos;
+            if ( match_segment( segment, name.data() + candidate ) ) return candidate;
+            pos = candidate + 1;
+        }
+
+        return std::string::npos;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool CompiledPattern::match( std::string_view name ) const
+    {
+        if ( m_segments.empty() )
+        {
+            // "" only matches "", any run of '*' matches everything.
+            return !m_anchor_start ? true : name.empty();
+        }
+
+        std::size_t first = 0, last = m_segments.size();
+        std::size_t pos = 0, end = name.size();
+
+        if ( m_anchor_start && m_anchor_end && last == 1 )
+        {
+            return name.size() == m_segments[0].width && match_segment( m_segments[0], name.data() );
+        }
+
+        if ( m_anchor_start )
+        {
+            const Segment & segment = m_segments[first++];
+            if ( segment.width > end || !match_segment( segment, name.data() ) ) return false;
+            pos = segment.width;
+        }
+
+        if ( m_anchor_end )
+        {
+            const Segment & segment = m_segments[--last];
+            if ( segment.width > end - pos || !match_segment( segment, name.data() + end - segment.width ) ) return false;
+            end -= segment.width;
+        }
+
+        // Greedy leftmost placement of the floating segments is optimal: each one has a fixed
+        // width, so matching it as early as possible leaves the most room for the rest.
+        std::string_view body = name.substr( 0, end );
+        for ( std::size_t i = first; i < last; ++i )
+        {
+            std::size_t found = find_segment( m_segments[i], body, pos );
+            if ( found == std::string::npos ) return false;
+            pos = found + m_segments[i].width;
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void CompiledPattern::filter( std::vector< std::string > & result, const std::vector< std::string > & names ) const
+    {
+        for ( const std::string & name : names )
+        {
+            if ( match( name ) ) result.push_back( name );
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool fnmatchcase( std::string_view name, std::string_view pattern )
+    {
+        return CompiledPattern( pattern ).match( name );
+    }
+
+    PYSTRING_INLINE bool fnmatch_nt( std::string_view name, std::string_view pattern )
+    {
+        return CompiledPattern( pattern, true ).match( name );
+    }
+
+    PYSTRING_INLINE bool fnmatch_posix( std::string_view name, std::string_view pattern )
+    {
+        return CompiledPattern( pattern ).match( name );
+    }
+
+    PYSTRING_INLINE bool fnmatch( std::string_view name, std::string_view pattern )
+    {
+#ifdef WINDOWS
+        return fnmatch_nt( name, pattern );
+#else
+        return fnmatch_posix( name, pattern );
+#endif
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void filter_nt( std::vector< std::string > & result, const std::vector< std::string > & names, std::string_view pattern )
+    {
+        result.clear();
+        CompiledPattern( pattern, true ).filter( result, names );
+    }
+
+    PYSTRING_INLINE void filter_posix( std::vector< std::string > & result, const std::vector< std::string > & names, std::string_view pattern )
+    {
+        result.clear();
+        CompiledPattern( pattern ).filter( result, names );
+    }
+
+    PYSTRING_INLINE void filter( std::vector< std::string > & result, const std::vector< std::string > & names, std::string_view pattern )
+    {
+#ifdef WINDOWS
+        filter_nt( result, names, pattern );
+#else
+        filter_posix( result, names, pattern );
+#endif
+    }
+
+    namespace detail
+    {
+        inline bool is_align( char c )
+        {
+            return c == '<' || c == '>' || c == '^' || c == '=';
+        }
+
+        // Parse a run of decimal digits into value, failing on overflow.
+        PYSTRING_INLINE bool parse_count( std::string_view text, std::size_t & i, int & value )
+        {
+            std::size_t begin = i;
+            long long v = 0;
+            while ( i < text.size() && text[i] >= '0' && text[i] <= '9' )
+            {
+                v = v * 10 + ( text[i] - '0' );
+                if ( v > MAX_32BIT_INT ) return false;
+                ++i;
+            }
+            value = (int) v;
+            return i > begin;
+        }
+
+        PYSTRING_INLINE const char digit_pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        // Write the decimal digits of v so that they end at end, two at a time, and return
+        // the first digit.
+        PYSTRING_INLINE char * write_decimal( char * end, unsigned long long v )
+        {
+            while ( v >= 100 )
+            {
+                const char * pair = digit_pairs + ( v % 100 ) * 2;
+                v /= 100;
+                *--end = pair[1];
+                *--end = pair[0];
+            }
+
+            if ( v >= 10 )
+            {
+                *--end = digit_pairs[v * 2 + 1];
+                *--end = digit_pairs[v * 2];
+            }
+            else
+            {
+                *--end = (char) ( '0' + v );
+            }
+            return end;
+        }
+
+        // The sign, digits or string and padding a field renders as.
+        struct FieldText
+        {
+            char digits[24];
+            std::string_view body;
+            char sign;
+            std::size_t left, right;    // fill either side of sign + body
+            std::size_t inner;          // fill between sign and body ('=' alignment)
+        };
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE CompiledFormat::CompiledFormat( std::string_view fmt ) : m_valid( true )
+    {
+        m_text.reserve( fmt.size() );
+
+        Piece piece = Piece();
+        piece.literal_offset = 0;
+        bool automatic = false, manual = false;
+        std::size_t next_index = 0;
+        std::size_t i = 0;
+
+        while ( i < fmt.size() && m_valid )
+        {
+            char c = fmt[i];
+
+            if ( c == '}' )
+            {
+                if ( i + 1 < fmt.size() && fmt[i + 1] == '}' )
+                {
+                    m_text += '}';
+                    i += 2;
+                    continue;
+                }
+                m_valid = false;
+                break;
+            }
+
+            if ( c != '{' )
+            {
+                m_text += c;
+                ++i;
+                continue;
+            }
+
+            if ( i + 1 < fmt.size() && fmt[i + 1] == '{' )
+            {
+                m_text += '{';
+                i += 2;
+                continue;
+            }
+
+            std::size_t close = fmt.find( '}', i + 1 );
+            std::size_t nested = fmt.find( '{', i + 1 );
+            if ( close == std::string_view::npos || nested < close )
+            {
+                m_valid = false;
+                break;
+            }
+
+            std::string_view body = fmt.substr( i + 1, close - i - 1 );
+            std::size_t spec_start = body.find( ':' );
+            std::string_view name = body.substr( 0, spec_start );
+            std::string_view spec = spec_start == std::string_view::npos ? std::string_view() : body.substr( spec_start + 1 );
+
+            // Conversions and attribute or index access are not supported.
+            if ( name.find_first_of( "!.[]" ) != std::string_view::npos )
+            {
+                m_valid = false;
+                break;
+            }
+
+            piece.literal_length = m_text.size() - piece.literal_offset;
+            piece.has_field = true;
+
+            Field & field = piece.field;
+            field.index = std::string::npos;
+            field.name_offset = field.name_length = 0;
+            field.width = 0;
+            field.precision = -1;
+            field.fill = ' ';
+            field.align = field.sign = field.type = 0;
+
+            if ( name.empty() )
+            {
+                automatic = true;
+                field.index = next_index++;
+            }
+            else if ( name.find_first_not_of( "0123456789" ) == std::string_view::npos )
+            {
+                int index = 0;
+                std::size_t k = 0;
+                if ( !detail::parse_count( name, k, index ) )
+                {
+                    m_valid = false;
+                    break;
+                }
+                manual = true;
+                field.index = (std::size_t) index;
+            }
+            else
+            {
+                field.name_offset = m_text.size();
+                field.name_length = name.size();
+                m_text += name;
+            }
+
+            if ( automatic && manual )
+            {
+                m_valid = false;
+                break;
+            }
+
+            std::size_t k = 0;
+            if ( spec.size() >= 2 && detail::is_align( spec[1] ) )
+            {
+                field.fill = spec[0];
+                field.align = spec[1];
+                k = 2;
+            }
+            else if ( !spec.empty() && detail::is_align( spec[0] ) )
+            {
+                field.align = spec[0];
+                k = 1;
+            }
+
+            if ( k < spec.size() && ( spec[k] == '+' || spec[k] == '-' || spec[k] == ' ' ) ) field.sign = spec[k++];
+
+            if ( k < spec.size() && spec[k] == '0' )
+            {
+                // Zero padding unless a fill was given, resolved to '=' alignment for integers
+                // and '<' for strings once the argument type is known.
+                ++k;
+                bool explicit_fill = spec.size() >= 2 && detail::is_align( spec[1] );
+                if ( !explicit_fill ) field.fill = '0';
+                if ( !field.align ) field.align = '0';
+            }
+
+            if ( k < spec.size() && spec[k] >= '0' && spec[k] <= '9' && !detail::parse_count( spec, k, field.width ) )
+            {
+                m_valid = false;
+                break;
+            }
+
+            if ( k < spec.size() && spec[k] == '.' )
+            {
+                ++k;
+                if ( !detail::parse_count( spec, k, field.precision ) )
+                {
+                    m_valid = false;
+                    break;
+                }
+            }
+
+            if ( k < spec.size() && ( spec[k] == 'd' || spec[k] == 's' ) ) field.type = spec[k++];
+
+            if ( k != spec.size() )
+            {
+                m_valid = false;
+                break;
+            }
+
+            field.raw_offset = m_text.size();
+            field.raw_length = close - i + 1;
+            m_text.append( fmt.data() + i, field.raw_length );
+
+            m_pieces.push_back( piece );
+            piece = Piece();
+            piece.literal_offset = m_text.size();
+            i = close + 1;
+        }
+
+        if ( !m_valid )
+        {
+            m_pieces.clear();
+            m_text.assign( fmt.data(), fmt.size() );
+            piece = Piece();
+        }
+
+        piece.literal_length = m_text.size() - piece.literal_offset;
+        piece.has_field = false;
+        if ( piece.literal_length ) m_pieces.push_back( piece );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE const FormatArg * CompiledFormat::lookup( const Field & field, const std::vector< FormatArg > & args, const FormatKwargs & kwargs ) const
+    {
+        if ( field.index != std::string::npos )
+        {
+            return field.index < args.size() ? &args[field.index] : nullptr;
+        }
+
+        FormatKwargs::const_iterator it = kwargs.find( std::string_view( m_text.data() + field.name_offset, field.name_length ) );
+        return it == kwargs.end() ? nullptr : &it->second;
+    }
+
+    namespace detail
+    {
+        // Lay out arg as the field's spec asks, or return false if the spec does not apply to
+        // the argument's type.
+        PYSTRING_INLINE bool layout_field( FieldText & text, const FormatArg & arg, int width, int precision, char align, char sign, char type )
+        {
+            text.sign = 0;
+            text.left = text.right = text.inner = 0;
+
+            if ( arg.is_int() )
+            {
+                if ( type == 's' || precision >= 0 ) return false;
+
+                bool negative = !arg.is_unsigned() && arg.as_int() < 0;
+                unsigned long long magnitude = negative ? 0ULL - arg.as_unsigned() : arg.as_unsigned();
+                char * end = text.digits + sizeof( text.digits );
+                char * begin = write_decimal( end, magnitude );
+                text.body = std::string_view( begin, (std::size_t) ( end - begin ) );
+
+                if ( negative ) text.sign = '-';
+                else if ( sign == '+' || sign == ' ' ) text.sign = sign;
+
+                if ( align == '0' ) align = '=';
+                if ( !align ) align = '>';
+            }
+            else
+            {
+                if ( type == 'd' || sign || align == '=' ) return false;
+
+                text.body = arg.as_string();
+                if ( precision >= 0 && (std::size_t) precision < text.body.size() ) text.body = text.body.substr( 0, (std::size_t) precision );
+
+                if ( !align || align == '0' ) align = '<';
+            }
+
+            std::size_t len = text.body.size() + ( text.sign ? 1 : 0 );
+            std::size_t pad = (std::size_t) width > len ? (std::size_t) width - len : 0;
+
+            switch ( align )
+            {
+                case '<': text.right = pad; break;
+                case '>': text.left = pad; break;
+                case '=': text.inner = pad; break;
+                default: text.left = pad / 2; text.right = pad - text.left; break;
+            }
+
+            return true;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void CompiledFormat::render_into( std::string & out, const std::vector< FormatArg > & args, const FormatKwargs & kwargs ) const
+    {
+        detail::FieldText text;
+
+        // Size the output exactly before writing any of it.
+        std::size_t total = out.size();
+        for ( const Piece & piece : m_pieces )
+        {
+            total += piece.literal_length;
+            if ( !piece.has_field ) continue;
+
+            const Field & field = piece.field;
+            const FormatArg * arg = lookup( field, args, kwargs );
+            if ( arg && detail::layout_field( text, *arg, field.width, field.precision, field.align, field.sign, field.type ) )
+            {
+                total += text.left + ( text.sign ? 1 : 0 ) + text.inner + text.body.size() + text.right;
+            }
+            else
+            {
+                total += field.raw_length;
+            }
+        }
+        out.reserve( total );
+
+        for ( const Piece & piece : m_pieces )
+        {
+            out.append( m_text.data() + piece.literal_offset, piece.literal_length );
+            if ( !piece.has_field ) continue;
+
+            const Field & field = piece.field;
+            const FormatArg * arg = lookup( field, args, kwargs );
+            if ( arg && detail::layout_field( text, *arg, field.width, field.precision, field.align, field.sign, field.type ) )
+            {
+                out.append( text.left, field.fill );
+                if ( text.sign ) out += text.sign;
+                out.append( text.inner, field.fill );
+                out.append( text.body.data(), text.body.size() );
+                out.append( text.right, field.fill );
+            }
+            else
+            {
+                out.append( m_text.data() + field.raw_offset, field.raw_length );
+            }
+        }
+    }
+
+    PYSTRING_INLINE std::string CompiledFormat::render( const std::vector< FormatArg > & args, const FormatKwargs & kwargs ) const
+    {
+        std::string out;
+        render_into( out, args, kwargs );
+        return out;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string format( std::string_view fmt, const std::vector< FormatArg > & args, const FormatKwargs & kwargs )
+    {
+        return CompiledFormat( fmt ).render( args, kwargs );
+    }
+
+    PYSTRING_INLINE std::string format_map( std::string_view fmt, const FormatKwargs & kwargs )
+    {
+        return CompiledFormat( fmt ).render( std::vector< FormatArg >(), kwargs );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void format_int_into( std::string & dst, long long n, int width, char fill )
+    {
+        char digits[24];
+        char * end = digits + sizeof( digits );
+        unsigned long long magnitude = n < 0 ? 0ULL - (unsigned long long) n : (unsigned long long) n;
+        char * begin = detail::write_decimal( end, magnitude );
+
+        std::size_t count = (std::size_t) ( end - begin );
+        std::size_t len = count + ( n < 0 ? 1 : 0 );
+        std::size_t pad = width > 0 && (std::size_t) width > len ? (std::size_t) width - len : 0;
+
+        std::size_t offset = dst.size();
+        dst.resize( offset + len + pad );
+        char * out = &dst[offset];
+
+        if ( fill == '0' )
+        {
+            if ( n < 0 ) *out++ = '-';
+            memset( out, '0', pad );
+            out += pad;
+        }
+        else
+        {
+            memset( out, fill, pad );
+            out += pad;
+            if ( n < 0 ) *out++ = '-';
+        }
+        memcpy( out, begin, count );
+    }
+
+    PYSTRING_INLINE std::string format_int( long long n, int width, char fill )
+    {
+        std::string result;
+        format_int_into( result, n, width, fill );
+        return result;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void format_int_range( std::vector< std::string > & result, long long first, long long last, int width, char fill )
+    {
+        if ( last <= first )
+        {
+            result.clear();
+            return;
+        }
+
+        result.resize( (std::size_t) ( last - first ) );
+        for ( std::string & s : result )
+        {
+            s.clear();
+            format_int_into( s, first++, width, fill );
+        }
+    }
+
+
+    namespace detail
+    {
+        inline int digit_value( char c )
+        {
+            if ( c >= '0' && c <= '9' ) return c - '0';
+            if ( c >= 'a' && c <= 'z' ) return c - 'a' + 10;
+            if ( c >= 'A' && c <= 'Z' ) return c - 'A' + 10;
+            return 36;
+        }
+
+        // Check that every underscore in digits sits between two characters that accept takes
+        // as digits, as python requires. A leading underscore is allowed after a base prefix.
+        template< typename Accept >
+        bool valid_digits( std::string_view digits, bool allow_leading_underscore, Accept accept, bool & has_underscore )
+        {
+            has_underscore = false;
+            for ( std::size_t i = 0; i < digits.size(); ++i )
+            {
+                if ( digits[i] == '_' )
+                {
+                    if ( i == 0 && !allow_leading_underscore ) return false;
+                    if ( i > 0 && !accept( digits[i - 1] ) ) return false;
+                    if ( i + 1 == digits.size() || !accept( digits[i + 1] ) ) return false;
+                    has_underscore = true;
+                }
+                else if ( !accept( digits[i] ) )
+                {
+                    return false;
+                }
+            }
+            return !digits.empty();
+        }
+
+        // Copy digits without its underscores into buffer, spilling to storage when it is
+        // too long, and return the result.
+        PYSTRING_INLINE std::string_view remove_underscores( std::string_view digits, char ( &buffer )[128], std::string & storage )
+        {
+            char * out = buffer;
+            if ( digits.size() > sizeof( buffer ) )
+            {
+                storage.resize( digits.size() );
+                out = &storage[0];
+            }
+
+            std::size_t n = 0;
+            for ( char c : digits )
+            {
+                if ( c != '_' ) out[n++] = c;
+            }
+            return std::string_view( out, n );
+        }
+
+        // Parse up to 19 decimal digits, eight at a time while at least eight remain.
+        PYSTRING_INLINE unsigned long long parse_decimal( std::string_view digits )
+        {
+            unsigned long long value = 0;
+            std::size_t i = 0;
+
+#ifndef PYSTRING_BIG_ENDIAN
+            for ( ; i + 8 <= digits.size(); i += 8 )
+            {
+                std::uint64_t chunk;
+                memcpy( &chunk, digits.data() + i, 8 );
+                chunk -= 0x3030303030303030ULL;
+                chunk = ( chunk * 10 ) + ( chunk >> 8 );
+                chunk = ( ( ( chunk & 0x000000FF000000FFULL ) * ( 100 + ( 1000000ULL << 32 ) ) ) +
+                          ( ( ( chunk >> 16 ) & 0x000000FF000000FFULL ) * ( 1 + ( 10000ULL << 32 ) ) ) ) >> 32;
+                value = value * 100000000ULL + chunk;
+            }
+#endif
+
+            for ( ; i < digits.size(); ++i ) value = value * 10 + (unsigned long long) ( digits[i] - '0' );
+            return value;
+        }
+
+        inline bool equals_ignore_case( std::string_view a, std::string_view lower )
+        {
+            if ( a.size() != lower.size() ) return false;
+            for ( std::size_t i = 0; i < a.size(); ++i )
+            {
+                if ( to_lower( a[i] ) != lower[i] ) return false;
+            }
+            return true;
+        }
+
+        // Return whether the decimal number text (no sign, no underscores), which the parser
+        // found out of range, overflows rather than underflows.
+        PYSTRING_INLINE bool decimal_overflows( std::string_view text )
+        {
+            std::size_t i = 0;
+            long long magnitude = 0;
+
+            while ( i < text.size() && text[i] == '0' ) ++i;
+            while ( i < text.size() && is_digit( text[i] ) ) { ++magnitude; ++i; }
+            if ( i < text.size() && text[i] == '.' )
+            {
+                ++i;
+                if ( magnitude == 0 )
+                {
+                    while ( i < text.size() && text[i] == '0' ) { --magnitude; ++i; }
+                }
+                while ( i < text.size() && is_digit( text[i] ) ) ++i;
+            }
+
+            if ( i < text.size() && ( text[i] == 'e' || text[i] == 'E' ) )
+            {
+                ++i;
+                bool negative = i < text.size() && text[i] == '-';
+                if ( i < text.size() && ( text[i] == '-' || text[i] == '+' ) ) ++i;
+
+                long long exponent = 0;
+                for ( ; i < text.size(); ++i )
+                {
+                    if ( exponent < 100000000 ) exponent = exponent * 10 + ( text[i] - '0' );
+                }
+                magnitude += negative ? -exponent : exponent;
+            }
+
+            return magnitude > 0;
+        }
+
+        // Convert decimal number text already validated as [digits][.digits][(e|E)[sign]digits].
+        // Floating-point from_chars needs libstdc++ 11 or a recent libc++; elsewhere strtod is
+        // used, with '.' swapped for the current locale's decimal point so that it parses the
+        // same way under any setlocale.
+        PYSTRING_INLINE std::errc parse_double( std::string_view text, double & value )
+        {
+#if defined(__cpp_lib_to_chars)
+            std::from_chars_result parsed = std::from_chars( text.data(), text.data() + text.size(), value );
+            if ( parsed.ptr != text.data() + text.size() ) return std::errc::invalid_argument;
+            if ( parsed.ec == std::errc::result_out_of_range )
+            {
+                value = decimal_overflows( text ) ? std::numeric_limits< double >::infinity() : 0.0;
+                return std::errc();
+            }
+            return parsed.ec;
+#else
+            const char * point = std::localeconv()->decimal_point;
+            std::size_t point_len = std::strlen( point );
+
+            std::string buffer;
+            buffer.reserve( text.size() + point_len );
+            for ( char c : text )
+            {
+                if ( c == '.' ) buffer.append( point, point_len );
+                else buffer += c;
+            }
+
+            char * end = nullptr;
+            errno = 0;
+            double parsed = std::strtod( buffer.c_str(), &end );
+            if ( end != buffer.c_str() + buffer.size() ) return std::errc::invalid_argument;
+            if ( errno == ERANGE && decimal_overflows( text ) ) parsed = std::numeric_limits< double >::infinity();
+            value = parsed;
+            return std::errc();
+#endif
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::errc to_int( std::string_view str, long long & value, int base )
+    {
+        if ( base != 0 && ( base < 2 || base > 36 ) ) return std::errc::invalid_argument;
+
+        std::string_view s = do_strip_view( str, string_strip_direction_::bothstrip, std::string_view() );
+
+        bool negative = false;
+        if ( !s.empty() && ( s[0] == '+' || s[0] == '-' ) )
+        {
+            negative = s[0] == '-';
+            s.remove_prefix( 1 );
+        }
+
+        bool prefixed = false;
+        if ( s.size() >= 2 && s[0] == '0' )
+        {
+            char p = detail::to_lower( s[1] );
+            int prefix_base = p == 'x' ? 16 : p == 'o' ? 8 : p == 'b' ? 2 : 0;
+            if ( prefix_base && ( base == 0 || base == prefix_base ) )
+            {
+                base = prefix_base;
+                prefixed = true;
+                s.remove_prefix( 2 );
+            }
+        }
+
+        // Without a prefix, base 0 is decimal but rejects leading zeros as python does.
+        bool no_leading_zeros = base == 0;
+        if ( base == 0 ) base = 10;
+
+        bool has_underscore;
+        if ( !detail::valid_digits( s, prefixed, [base]( char c ) { return detail::digit_value( c ) < base; }, has_underscore ) )
+        {
+            return std::errc::invalid_argument;
+        }
+
+        char buffer[128];
+        std::string storage;
+        if ( has_underscore ) s = detail::remove_underscores( s, buffer, storage );
+
+        if ( no_leading_zeros && s.size() > 1 && s[0] == '0' && s.find_first_not_of( '0' ) != std::string_view::npos )
+        {
+            return std::errc::invalid_argument;
+        }
+
+        unsigned long long magnitude;
+        if ( base == 10 && s.size() <= 19 )
+        {
+            magnitude = detail::parse_decimal( s );
+        }
+        else
+        {
+            std::from_chars_result parsed = std::from_chars( s.data(), s.data() + s.size(), magnitude, base );
+            if ( parsed.ec != std::errc() ) return parsed.ec;
+        }
+
+        const unsigned long long limit = (unsigned long long) std::numeric_limits< long long >::max();
+        if ( magnitude > limit + ( negative ? 1 : 0 ) ) return std::errc::result_out_of_range;
+
+        value = negative ? -(long long) ( magnitude - 1 ) - 1 : (long long) magnitude;
+        return std::errc();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::errc to_float( std::string_view str, double & value )
+    {
+        std::string_view s = do_strip_view( str, string_strip_direction_::bothstrip, std::string_view() );
+
+        bool negative = false;
+        if ( !s.empty() && ( s[0] == '+' || s[0] == '-' ) )
+        {
+            negative = s[0] == '-';
+            s.remove_prefix( 1 );
+        }
+
+        if ( detail::equals_ignore_case( s, "inf" ) || detail::equals_ignore_case( s, "infinity" ) )
+        {
+            value = negative ? -std::numeric_limits< double >::infinity() : std::numeric_limits< double >::infinity();
+            return std::errc();
+        }
+
+        if ( detail::equals_ignore_case( s, "nan" ) )
+        {
+            value = negative ? -std::numeric_limits< double >::quiet_NaN() : std::numeric_limits< double >::quiet_NaN();
+            return std::errc();
+        }
+
+        // Everything else must look like [digits][.digits][(e|E)[sign]digits]; from_chars and
+        // strtod would also accept hex floats and "nan(...)", which python does not.
+        bool has_underscore = false;
+        for ( char c : s )
+        {
+            if ( !detail::is_digit( c ) && c != '.' && c != 'e' && c != 'E' && c != '+' && c != '-' && c != '_' )
+            {
+                return std::errc::invalid_argument;
+            }
+            has_underscore |= c == '_';
+        }
+
+        char buffer[128];
+        std::string storage;
+        if ( has_underscore )
+        {
+            bool unused;
+            std::size_t k = 0;
+            while ( k < s.size() )
+            {
+                // Validate each run of digits separately so that "1_.5" and "1e_5" fail.
+                std::size_t run = k;
+                while ( run < s.size() && ( detail::is_digit( s[run] ) || s[run] == '_' ) ) ++run;
+                if ( run > k && !detail::valid_digits( s.substr( k, run - k ), false, detail::is_digit, unused ) )
+                {
+                    return std::errc::invalid_argument;
+                }
+                k = run == k ? k + 1 : run;
+            }
+            s = detail::remove_underscores( s, buffer, storage );
+        }
+
+        if ( s.empty() || s[0] == '+' || s[0] == '-' ) return std::errc::invalid_argument;
+
+        double parsed_value;
+        std::errc ec = detail::parse_double( s, parsed_value );
+        if ( ec != std::errc() ) return ec;
+
+        value = negative ? -parsed_value : parsed_value;
+        return std::errc();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::size_t to_int( const std::vector< std::string > & fields, long long * result, int base )
+    {
+        for ( std::size_t i = 0; i < fields.size(); ++i )
+        {
+            if ( to_int( fields[i], result[i], base ) != std::errc() ) return i;
+        }
+        return fields.size();
+    }
+
+    PYSTRING_INLINE std::size_t to_float( const std::vector< std::string > & fields, double * result )
+    {
+        for ( std::size_t i = 0; i < fields.size(); ++i )
+        {
+            if ( to_float( fields[i], result[i] ) != std::errc() ) return i;
+        }
+        return fields.size();
+    }
+
+
+    namespace detail
+    {
+        inline bool is_shlex_space( char c )
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        inline bool is_shlex_safe( char c )
+        {
+            return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) ||
+                   ( c != '\0' && strchr( "_@%+=:,./-", c ) != nullptr );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// Tokenize str the way python's shlex.split does in POSIX mode, handing each token to
+        /// emit. Tokens without quotes or escapes are views into str; the others are unescaped
+        /// into buffer, which is reserved to str's size on first use so that it never moves
+        /// once a view into it has been emitted. Return false on an unterminated quote or a
+        /// trailing escape.
+        ///
+        template< typename Emit >
+        bool shlex_tokens( std::string_view str, std::string & buffer, Emit emit )
+        {
+            std::size_t i = 0, n = str.size();
+            buffer.clear();
+
+            for ( ;; )
+            {
+                while ( i < n && is_shlex_space( str[i] ) ) ++i;
+                if ( i == n ) return true;
+
+                std::size_t start = i, buffer_start = 0;
+                bool copying = false;
+
+                // Switch to building the token in buffer, starting with what was read so far.
+                auto begin_copy = [&]()
+                {
+                    if ( copying ) return;
+                    if ( buffer.capacity() < n ) buffer.reserve( n );
+                    buffer_start = buffer.size();
+                    buffer.append( str.data() + start, i - start );
+                    copying = true;
+                };
+
+                while ( i < n && !is_shlex_space( str[i] ) )
+                {
+                    char c = str[i];
+                    if ( c == '\'' )
+                    {
+                        begin_copy();
+                        std::size_t close = str.find( '\'', i + 1 );
+                        if ( close == std::string_view::npos ) return false;
+                        buffer.append( str.data() + i + 1, close - i - 1 );
+                        i = close + 1;
+                    }
+                    else if ( c == '"' )
+                    {
+                        begin_copy();
+                        for ( ++i; i < n && str[i] != '"'; ++i )
+                        {
+                            // Only the quote and the escape itself can be escaped in double quotes.
+                            if ( str[i] == '\\' )
+                            {
+                                if ( i + 1 == n ) return false;
+                                if ( str[i + 1] == '"' || str[i + 1] == '\\' ) ++i;
+                            }
+                            buffer += str[i];
+                        }
+                        if ( i == n ) return false;
+                        ++i;
+                    }
+                    else if ( c == '\\' )
+                    {
+                        begin_copy();
+                        if ( i + 1 == n ) return false;
+                        buffer += str[i + 1];
+                        i += 2;
+                    }
+                    else
+                    {
+                        if ( copying ) buffer += c;
+                        ++i;
+                    }
+                }
+
+                if ( copying )
+                {
+                    emit( std::string_view( buffer.data() + buffer_start, buffer.size() - buffer_start ) );
+                }
+                else
+                {
+                    emit( str.substr( start, i - start ) );
+                }
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool shlex_split( std::string_view str, std::vector< std::string > & result )
+    {
+        result.clear();
+        std::string buffer;
+        if ( detail::shlex_tokens( str, buffer, [&result]( std::string_view token ) { result.emplace_back( token ); } ) ) return true;
+
+        result.clear();
+        return false;
+    }
+
+    PYSTRING_INLINE bool shlex_split_view( std::string_view str, small_vector_base< std::string_view > & result, std::string & buffer )
+    {
+        result.clear();
+        if ( detail::shlex_tokens( str, buffer, [&result]( std::string_view token ) { result.push_back( token ); } ) ) return true;
+
+        result.clear();
+        return false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string shlex_quote( std::string_view str )
+    {
+        if ( str.empty() ) return "''";
+        if ( std::all_of( str.begin(), str.end(), detail::is_shlex_safe ) ) return std::string( str );
+
+        // Close the quote, add the quote escaped in double quotes and reopen it: ' -> '"'"'
+        std::string result;
+        result.reserve( str.size() + 2 );
+        result += '\'';
+        for ( char c : str )
+        {
+            if ( c == '\'' ) result += "'\"'\"'";
+            else result += c;
+        }
+        result += '\'';
+        return result;
+    }
+
+    PYSTRING_INLINE std::string shlex_join( const std::vector< std::string > & args )
+    {
+        std::string result;
+        for ( std::size_t i = 0; i < args.size(); ++i )
+        {
+            if ( i ) result += ' ';
+            result += shlex_quote( args[i] );
+        }
+        return result;
+    }
+
+
+    namespace detail
+    {
+        PYSTRING_INLINE const std::size_t intern_shard_count = 64;
+        PYSTRING_INLINE const std::size_t intern_min_block_size = 1024;
+        PYSTRING_INLINE const std::size_t intern_block_size = 64 * 1024;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// 64-bit hash of a string, eight bytes per multiply.
+        ///
+        PYSTRING_INLINE std::uint64_t hash_bytes( const char * s, std::size_t len )
+        {
+            const std::uint64_t k = 0x9E3779B97F4A7C15ULL;
+            std::uint64_t h = len * k;
+            std::size_t i = 0;
+            for ( ; i + 8 <= len; i += 8 )
+            {
+                std::uint64_t word;
+                memcpy( &word, s + i, 8 );
+                h = ( h ^ word ) * k;
+                h ^= h >> 29;
+            }
+            if ( i < len )
+            {
+                std::uint64_t word = 0;
+                memcpy( &word, s + i, len - i );
+                h = ( h ^ word ) * k;
+            }
+            h ^= h >> 32;
+            h *= k;
+            return h ^ ( h >> 29 );
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    struct InternPool::Shard
+    {
+        struct Slot
+        {
+            const char * data;
+            std::size_t length;
+            std::uint64_t hash;
+        };
+
+        std::mutex mutex;
+        std::vector< Slot > slots;      // power of two sized, data is null for an empty slot
+        std::size_t count = 0;
+        std::vector< std::unique_ptr< char[] > > blocks;
+        char * block_pos = nullptr;
+        std::size_t block_left = 0;
+        std::size_t block_size = 0;
+
+        const char * store( std::string_view str )
+        {
+            // Long strings get a block of their own so they do not waste the current one.
+            if ( str.size() > detail::intern_block_size / 4 )
+            {
+                blocks.emplace_back( new char[str.size()] );
+                memcpy( blocks.back().get(), str.data(), str.size() );
+                return blocks.back().get();
+            }
+
+            // Blocks start small and double up to intern_block_size, so a pool holding a
+            // few strings does not cost a full block in every shard.
+            if ( str.size() > block_left )
+            {
+                block_size = block_size ? block_size * 2 : detail::intern_min_block_size;
+                while ( block_size < str.size() ) block_size *= 2;
+                if ( block_size > detail::intern_block_size ) block_size = detail::intern_block_size;
+
+                blocks.emplace_back( new char[block_size] );
+                block_pos = blocks.back().get();
+                block_left = block_size;
+            }
+
+            char * data = block_pos;
+            memcpy( data, str.data(), str.size() );
+            block_pos += str.size();
+            block_left -= str.size();
+            return data;
+        }
+
+        void grow()
+        {
+            std::vector< Slot > old( slots.size() ? slots.size() * 2 : 64, Slot{ nullptr, 0, 0 } );
+            old.swap( slots );
+
+            std::size_t mask = slots.size() - 1;
+            for ( const Slot & slot : old )
+            {
+                if ( !slot.data ) continue;
+                std::size_t i = (std::size_t) slot.hash & mask;
+                while ( slots[i].data ) i = ( i + 1 ) & mask;
+                slots[i] = slot;
+            }
+        }
+
+        std::string_view intern( std::string_view str, std::uint64_t hash )
+        {
+            std::lock_guard< std::mutex > lock( mutex );
+
+            if ( ( count + 1 ) * 2 > slots.size() ) grow();
+
+            std::size_t mask = slots.size() - 1;
+            std::size_t i = (std::size_t) hash & mask;
+            while ( slots[i].data )
+            {
+                const Slot & slot = slots[i];
+                if ( slot.hash == hash && slot.length == str.size() && memcmp( slot.data, str.data(), str.size() ) == 0 )
+                {
+                    return std::string_view( slot.data, slot.length );
+                }
+                i = ( i + 1 ) & mask;
+            }
+
+            slots[i] = Slot{ store( str ), str.size(), hash };
+            ++count;
+            return std::string_view( slots[i].data, slots[i].length );
+        }
+    };
+
+    PYSTRING_INLINE InternPool::InternPool() : m_shards( new Shard[detail::intern_shard_count] )
+    {
+    }
+
+    PYSTRING_INLINE InternPool::~InternPool()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string_view InternPool::intern( std::string_view str )
+    {
+        // Every empty string interns to the same static one, which needs no storage.
+        if ( str.empty() ) return std::string_view( empty_string.data(), 0 );
+
+        // The low bits pick the slot, so pick the shard with the high ones.
+        std::uint64_t hash = detail::hash_bytes( str.data(), str.size() );
+        return m_shards[( hash >> 32 ) % detail::intern_shard_count].intern( str, hash );
+    }
+
+    PYSTRING_INLINE std::size_t InternPool::size() const
+    {
+        std::size_t total = 0;
+        for ( std::size_t i = 0; i < detail::intern_shard_count; ++i )
+        {
+            std::lock_guard< std::mutex > lock( m_shards[i].mutex );
+            total += m_shards[i].count;
+        }
+        return total;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void split_intern( std::string_view str, std::vector< std::string_view > & result, InternPool & pool, std::string_view sep, int maxsplit )
+    {
+        result.clear();
+        detail::split_fields( str, sep, maxsplit, [&]( std::string_view field )
+        {
+            result.push_back( pool.intern( field ) );
+            return true;
+        } );
+    }
+
+
+    namespace detail
+    {
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// Fill a column from a field producer: count the fields, size the column once, then
+        /// append them. fields( emit ) runs one of the split cores.
+        ///
+        template< typename Offset, typename Fields >
+        bool fill_column( std::string_view str, BasicStringColumn< Offset > & result, Fields fields )
+        {
+            result.clear();
+            if ( str.size() > BasicStringColumn< Offset >::max_bytes() ) return false;
+
+            std::size_t count = 0;
+            fields( [&count]( std::string_view ) { ++count; return true; } );
+
+            result.reserve( count, str.size() );
+            fields( [&result]( std::string_view field ) { return result.append( field ); } );
+            return true;
+        }
+
+        template< typename Offset >
+        std::string join_column( std::string_view str, const BasicStringColumn< Offset > & seq )
+        {
+            if ( seq.empty() ) return std::string();
+            if ( str.empty() ) return std::string( seq.bytes() );
+
+            std::string result;
+            result.reserve( seq.bytes().size() + str.size() * ( seq.size() - 1 ) );
+            result.append( seq[0] );
+            for ( std::size_t i = 1; i < seq.size(); ++i )
+            {
+                result.append( str );
+                result.append( seq[i] );
+            }
+            return result;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool split_to_column( std::string_view str, StringColumn & result, std::string_view sep, int maxsplit )
+    {
+        return detail::fill_column( str, result, [&]( auto emit ) { split_fields( str, sep, maxsplit, emit ); } );
+    }
+
+    PYSTRING_INLINE bool split_to_column( std::string_view str, LargeStringColumn & result, std::string_view sep, int maxsplit )
+    {
+        return detail::fill_column( str, result, [&]( auto emit ) { split_fields( str, sep, maxsplit, emit ); } );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool splitlines_to_column( std::string_view str, StringColumn & result, bool keepends )
+    {
+        return detail::fill_column( str, result, [&]( auto emit ) { splitlines_fields( str, keepends, emit ); } );
+    }
+
+    PYSTRING_INLINE bool splitlines_to_column( std::string_view str, LargeStringColumn & result, bool keepends )
+    {
+        return detail::fill_column( str, result, [&]( auto emit ) { splitlines_fields( str, keepends, emit ); } );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string join( std::string_view str, const StringColumn & seq )
+    {
+        return detail::join_column( str, seq );
+    }
+
+    PYSTRING_INLINE std::string join( std::string_view str, const LargeStringColumn & seq )
+    {
+        return detail::join_column( str, seq );
+    }
+
+
+    namespace detail
+    {
+        PYSTRING_INLINE const std::size_t builder_first_block = 4 * 1024;
+        PYSTRING_INLINE const std::size_t builder_max_block = 1024 * 1024;
+    }
+
+    PYSTRING_INLINE StringBuilder::StringBuilder()
+        : m_block_pos( nullptr ), m_block_left( 0 ), m_block_size( detail::builder_first_block ), m_size( 0 )
+    {
+    }
+
+    PYSTRING_INLINE StringBuilder::~StringBuilder()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// Return room for n bytes in the arena, recorded as part of the builder's contents. A
+    /// piece that continues the previous chunk in the same block extends that chunk, so runs
+    /// of small appends gather into a few large chunks. Blocks double up to builder_max_block;
+    /// pieces larger than the next block get one of their own.
+    ///
+    PYSTRING_INLINE char * StringBuilder::reserve( std::size_t n )
     {
-        std::string::size_type len = str.size(), i;
-        if ( len == 0 ) return false;
-        if( len == 1 ) return ::isupper( str[0] );
-
-        for ( i = 0; i < len; ++i )
+        if ( n > m_block_left )
         {
-           if ( !::isupper( str[i] ) ) return false;
+            std::size_t size = std::max( n, m_block_size );
+            m_blocks.emplace_back( new char[size] );
+            m_block_pos = m_blocks.back().get();
+            m_block_left = size;
+            if ( m_block_size < detail::builder_max_block ) m_block_size *= 2;
         }
-        return true;
+
+        char * data = m_block_pos;
+        m_block_pos += n;
+        m_block_left -= n;
+        m_size += n;
+
+        if ( !m_chunks.empty() && m_chunks.back().data + m_chunks.back().size == data ) m_chunks.back().size += n;
+        else m_chunks.push_back( Chunk{ data, n } );
+        return data;
+    }
+
+    PYSTRING_INLINE void StringBuilder::append_copy( const char * data, std::size_t n )
+    {
+        if ( n ) memcpy( reserve( n ), data, n );
+    }
+
+    PYSTRING_INLINE void StringBuilder::append_fill( char fill, std::size_t n )
+    {
+        if ( n ) memset( reserve( n ), fill, n );
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string capitalize( std::string_view str )
+    PYSTRING_INLINE void StringBuilder::append( std::string_view str )
     {
-        std::string s( str );
-        std::string::size_type len = s.size(), i;
+        append_copy( str.data(), str.size() );
+    }
 
-        if ( len > 0)
+    PYSTRING_INLINE void StringBuilder::append_view( std::string_view str )
+    {
+        if ( str.empty() ) return;
+        m_chunks.push_back( Chunk{ str.data(), str.size() } );
+        m_size += str.size();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void StringBuilder::append_join( std::string_view str, const std::vector< std::string > & seq )
+    {
+        if ( seq.empty() ) return;
+
+        std::size_t total = str.size() * ( seq.size() - 1 );
+        for ( const std::string & item : seq ) total += item.size();
+        if ( total == 0 ) return;
+
+        char * out = reserve( total );
+        for ( std::size_t i = 0; i < seq.size(); ++i )
         {
-            if (::islower(s[0])) s[0] = (char) ::toupper( s[0] );
+            if ( i && !str.empty() )
+            {
+                memcpy( out, str.data(), str.size() );
+                out += str.size();
+            }
+            if ( !seq[i].empty() )
+            {
+                memcpy( out, seq[i].data(), seq[i].size() );
+                out += seq[i].size();
+            }
         }
+    }
 
-        for ( i = 1; i < len; ++i )
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void StringBuilder::append_padded( std::string_view str, int width, char align, char fill )
+    {
+        if ( width <= 0 || str.size() >= (std::size_t) width )
         {
-            if (::isupper(s[i])) s[i] = (char) ::tolower( s[i] );
+            append( str );
+            return;
         }
 
-        return s;
+        // Split the padding as ljust, rjust and center do.
+        std::size_t marg = (std::size_t) width - str.size(), left = 0;
+        if ( align == '>' ) left = marg;
+        else if ( align == '^' ) left = marg / 2 + ( marg & (std::size_t) width & 1 );
+
+        append_fill( fill, left );
+        append_copy( str.data(), str.size() );
+        append_fill( fill, marg - left );
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string lower( std::string_view str )
+    PYSTRING_INLINE void StringBuilder::append_replace( std::string_view str, std::string_view oldstr, std::string_view newstr, int count )
     {
-        std::string s( str );
-        std::string::size_type len = s.size(), i;
+        detail::replace_pieces( str, oldstr, newstr, count, [this]( std::string_view piece )
+        {
+            append_copy( piece.data(), piece.size() );
+        } );
+    }
 
-        for ( i = 0; i < len; ++i )
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string StringBuilder::str() const
+    {
+        std::string result;
+        str_into( result );
+        return result;
+    }
+
+    PYSTRING_INLINE void StringBuilder::str_into( std::string & out ) const
+    {
+        out.reserve( out.size() + m_size );
+        for ( const Chunk & chunk : m_chunks ) out.append( chunk.data, chunk.size );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool StringBuilder::write( int fd ) const
+    {
+        std::size_t i = 0, offset = 0;
+#ifdef WINDOWS
+        for ( ; i < m_chunks.size(); ++i )
+        {
+            for ( offset = 0; offset < m_chunks[i].size; )
+            {
+                unsigned int n = (unsigned int) std::min< std::size_t >( m_chunks[i].size - offset, INT_MAX );
+                int written = ::_write( fd, m_chunks[i].data + offset, n );
+                if ( written < 0 ) return false;
+                offset += (std::size_t) written;
+            }
+        }
+#else
+        // Gather up to 64 chunks per call, resuming mid-chunk after a short write.
+        const int max_iov = 64;
+        struct iovec iov[max_iov];
+        while ( i < m_chunks.size() )
         {
-            if ( ::isupper( s[i] ) ) s[i] = (char) ::tolower( s[i] );
+            int n = 0;
+            for ( std::size_t j = i; j < m_chunks.size() && n < max_iov; ++j, ++n )
+            {
+                std::size_t skip = j == i ? offset : 0;
+                iov[n].iov_base = const_cast< char * >( m_chunks[j].data + skip );
+                iov[n].iov_len = m_chunks[j].size - skip;
+            }
+
+            ssize_t written = ::writev( fd, iov, n );
+            if ( written < 0 )
+            {
+                if ( errno == EINTR ) continue;
+                return false;
+            }
+
+            std::size_t left = (std::size_t) written;
+            while ( left && i < m_chunks.size() )
+            {
+                std::size_t remaining = m_chunks[i].size - offset;
+                if ( left < remaining )
+                {
+                    offset += left;
+                    break;
+                }
+                left -= remaining;
+                offset = 0;
+                ++i;
+            }
         }
+#endif
+        return true;
+    }
 
-        return s;
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE void StringBuilder::clear()
+    {
+        m_chunks.clear();
+        m_blocks.clear();
+        m_block_pos = nullptr;
+        m_block_left = 0;
+        m_block_size = detail::builder_first_block;
+        m_size = 0;
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string upper( std::string_view str )
+    PYSTRING_INLINE isa selected_isa()
     {
-        std::string s( str ) ;
-        std::string::size_type len = s.size(), i;
+        return detail::kernels().level;
+    }
 
-        for ( i = 0; i < len; ++i )
+    PYSTRING_INLINE bool isa_supported( isa level )
+    {
+        return level <= detail::best_isa();
+    }
+
+    PYSTRING_INLINE bool force_isa( isa level )
+    {
+        if ( !isa_supported( level ) ) return false;
+        detail::active_kernels.store( &detail::kernels_for( level ), std::memory_order_release );
+        return true;
+    }
+
+    PYSTRING_INLINE const char * isa_name( isa level )
+    {
+        switch ( level )
         {
-            if ( ::islower( s[i] ) ) s[i] = (char) ::toupper( s[i] );
+        case isa::sse2: return "sse2";
+        case isa::avx2: return "avx2";
+        default: return "scalar";
         }
-
-        return s;
     }
 
+
+namespace os
+{
+namespace path
+{
+    
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string swapcase( std::string_view str )
-    {
-        std::string s( str );
-        std::string::size_type len = s.size(), i;
+    /// These functions are C++ ports of the python2.6 versions of os.path,
+    /// and come from genericpath.py, ntpath.py, posixpath.py
 
-        for ( i = 0; i < len; ++i )
+    /// Split a pathname into drive and path specifiers.
+    /// Returns drivespec, pathspec. Either part may be empty.
+    PYSTRING_INLINE void splitdrive_nt(std::string & drivespec, std::string & pathspec,
+                       std::string_view p)
+    {
+        if (p.size() >= 2 && p[1] == ':')
         {
-            if ( ::islower( s[i] ) ) s[i] = (char) ::toupper( s[i] );
-            else if (::isupper( s[i] ) ) s[i] = (char) ::tolower( s[i] );
+            // p may view drivespec or pathspec, so keep the two drive bytes aside and assign
+            // pathspec first; assigning a string a view of its own tail is well defined.
+            const char drive[2] = { p[0], p[1] };
+            pathspec = pystring::slice_view(p, 2);
+            drivespec.assign(drive, 2);
         }
+        else
+        {
+            // As above, p may view drivespec: copy it out before clearing drivespec.
+            pathspec = p;
+            drivespec = empty_string;
+        }
+    }
 
-        return s;
+    // On Posix, drive is always empty
+    PYSTRING_INLINE void splitdrive_posix(std::string & drivespec, std::string & pathspec,
+                          std::string_view path)
+    {
+        drivespec = empty_string;
+        pathspec = path;
+    }
+
+    PYSTRING_INLINE void splitdrive(std::string & drivespec, std::string & pathspec,
+                    std::string_view path)
+    {
+#ifdef WINDOWS
+        return splitdrive_nt(drivespec, pathspec, path);
+#else
+        return splitdrive_posix(drivespec, pathspec, path);
+#endif
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string title( std::string_view str )
+
+    // Test whether a path is absolute
+    // In windows, if the character to the right of the colon
+    // is a forward or backslash it's absolute.
+    PYSTRING_INLINE bool isabs_nt(std::string_view path)
     {
-        std::string s( str );
-        std::string::size_type len = s.size(), i;
-        bool previous_is_cased = false;
+        std::string drivespec, pathspec;
+        splitdrive_nt(drivespec, pathspec, path);
+        if(pathspec.empty()) return false;
+        return ((pathspec[0] == '/') || (pathspec[0] == '\\'));
+    }
 
-        for ( i = 0; i < len; ++i )
+    PYSTRING_INLINE bool isabs_posix(std::string_view s)
+    {
+        return pystring::startswith(s, forward_slash);
+    }
+
+    PYSTRING_INLINE bool isabs(std::string_view path)
+    {
+#ifdef WINDOWS
+        return isabs_nt(path);
+#else
+        return isabs_posix(path);
+#endif
+    }
+
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    
+    PYSTRING_INLINE std::string abspath_nt(std::string_view path, std::string_view cwd)
+    {
+        std::string p = std::string(path);
+        if(!isabs_nt(p)) p = join_nt(cwd, p);
+        return normpath_nt(p);
+    }
+    
+    PYSTRING_INLINE std::string abspath_posix(std::string_view path, std::string_view cwd)
+    {
+        std::string p = std::string(path);
+        if(!isabs_posix(p)) p = join_posix(cwd, p);
+        return normpath_posix(p);
+    }
+    
+    PYSTRING_INLINE std::string abspath(std::string_view path, std::string_view cwd)
+    {
+#ifdef WINDOWS
+        return abspath_nt(path, cwd);
+#else
+        return abspath_posix(path, cwd);
+#endif
+    }
+    
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+
+    PYSTRING_INLINE std::string join_nt(const std::vector< std::string > & paths)
+    {
+        if(paths.empty()) return empty_string;
+        if(paths.size() == 1) return paths[0];
+        
+        std::string path = paths[0];
+        
+        for(unsigned int i=1; i<paths.size(); ++i)
         {
-            int c = s[i];
-            if ( ::islower(c) )
+            std::string b = paths[i];
+            
+            bool b_nts = false;
+            if(path.empty())
             {
-                if ( !previous_is_cased )
+                b_nts = true;
+            }
+            else if(isabs_nt(b))
+            {
+                // This probably wipes out path so far.  However, it's more
+                // complicated if path begins with a drive letter:
+                //     1. join('c:', '/a') == 'c:/a'
+                //     2. join('c:/', '/a') == 'c:/a'
+                // But
+                //     3. join('c:/a', '/b') == '/b'
+                //     4. join('c:', 'd:/') = 'd:/'
+                //     5. join('c:/', 'd:/') = 'd:/'
+                
+
+                if ((path.size() >= 2 && path[1] != ':') || (b.size() >= 2 && b[1] == ':'))
+                {
+                    // Path doesnt start with a drive letter
+                    b_nts = true;
+                }
+                // Else path has a drive letter, and b doesn't but is absolute.
+                else if((path.size()>3) || 
+                        ((path.size()==3) && !pystring::endswith(path, forward_slash) && !pystring::endswith(path, double_back_slash)))
+                {
+                    b_nts = true;
+                }
+            }
+            
+            if(b_nts)
+            {
+                path = b;
+            }
+            else
+            {
+                // Join, and ensure there's a separator.
+                // assert len(path) > 0
+                if( pystring::endswith(path, forward_slash) || pystring::endswith(path, double_back_slash))
+                {
+                    if(pystring::startswith(b,forward_slash) || pystring::startswith(b,double_back_slash))
+                    {
+                        path += pystring::slice_view(b, 1);
+                    }
+                    else
+                    {
+                        path += b;
+                    }
+                }
+                else if(pystring::endswith(path, colon))
+                {
+                    path += b;
+                }
+                else if(!b.empty())
                 {
-                    s[i] = (char) ::toupper(c);
+                    if(pystring::startswith(b, forward_slash) || pystring::startswith(b,double_back_slash))
+                    {
+                        path += b;
+                    }
+                    else
+                    {
+                        path += double_back_slash + b;
+                    }
                 }
-                previous_is_cased = true;
-            }
-            else if ( ::isupper(c) )
-            {
-                if ( previous_is_cased )
+                else
                 {
-                    s[i] = (char) ::tolower(c);
+                    // path is not empty and does not end with a backslash,
+                    // but b is empty; since, e.g., split('a/') produces
+                    // ('a', ''), it's best if join() adds a backslash in
+                    // this case.
+                    path += double_back_slash;
                 }
-                previous_is_cased = true;
-            }
-            else
-            {
-                previous_is_cased = false;
             }
         }
-
-        return s;
+        
+        return path;
     }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string translate( std::string_view str, std::string_view table, std::string_view deletechars )
+    
+    // Join two or more pathname components, inserting double_back_slash as needed.
+    PYSTRING_INLINE std::string join_nt(std::string_view a, std::string_view b)
     {
-        std::string s;
-        std::string::size_type len = str.size(), dellen = deletechars.size();
+        std::vector< std::string > paths(2);
+        paths[0] = a;
+        paths[1] = b;
+        return join_nt(paths);
+    }
 
-        if ( table.size() != 256 )
-        {
-            // TODO : raise exception instead
-            return std::string(str);
-        }
+    // Join pathnames.
+    // If any component is an absolute path, all previous path components
+    // will be discarded.
+    // Ignore the previous parts if a part is absolute.
+    // Insert a '/' unless the first part is empty or already ends in '/'.
 
-        //if nothing is deleted, use faster code
-        if ( dellen == 0 )
+    PYSTRING_INLINE std::string join_posix(const std::vector< std::string > & paths)
+    {
+        if(paths.empty()) return empty_string;
+        if(paths.size() == 1) return paths[0];
+        
+        std::string path = paths[0];
+        
+        for(unsigned int i=1; i<paths.size(); ++i)
         {
-            s = str;
-            for ( std::string::size_type i = 0; i < len; ++i )
+            std::string b = paths[i];
+            if(pystring::startswith(b, forward_slash))
             {
-                s[i] = table[ s[i] ];
+                path = b;
             }
-            return s;
-        }
-
-
-        int trans_table[256];
-        for ( int i = 0; i < 256; i++)
-        {
-            trans_table[i] = table[i];
-        }
-
-        for ( std::string::size_type i = 0; i < dellen; i++)
-        {
-            trans_table[(int) deletechars[i] ] = -1;
-        }
-
-        for ( std::string::size_type i = 0; i < len; ++i )
-        {
-            if ( trans_table[ (int) str[i] ] != -1 )
+            else if(path.empty() || pystring::endswith(path, forward_slash))
+            {
+                path += b;
+            }
+            else
             {
-                s += table[ str[i] ];
+                path += forward_slash + b;
             }
         }
+        
+        return path;
+    }
 
-        return s;
-
+    PYSTRING_INLINE std::string join_posix(std::string_view a, std::string_view b)
+    {
+        std::vector< std::string > paths(2);
+        paths[0] = a;
+        paths[1] = b;
+        return join_posix(paths);
+    }
+    
+    PYSTRING_INLINE std::string join(std::string_view path1, std::string_view path2)
+    {
+#ifdef WINDOWS
+        return join_nt(path1, path2);
+#else
+        return join_posix(path1, path2);
+#endif
     }
 
 
+    PYSTRING_INLINE std::string join(const std::vector< std::string > & paths)
+    {
+#ifdef WINDOWS
+        return join_nt(paths);
+#else
+        return join_posix(paths);
+#endif
+    }
+    
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string zfill( std::string_view str, int width )
-    {
-        int len = (int)str.size();
 
-        if ( len >= width )
+        
+    // Split a pathname.
+    // Return (head, tail) where tail is everything after the final slash.
+    // Either part may be empty
+
+    PYSTRING_INLINE void split_nt(std::string & head, std::string & tail, std::string_view path)
+    {
+        std::string d, p;
+        splitdrive_nt(d, p, path);
+        
+        // set i to index beyond p's last slash, looking for a '/' only after the last '\\'
+        std::size_t back = detail::rfind_byte(p.data(), p.size(), '\\');
+        std::size_t from = back == std::string::npos ? 0 : back + 1;
+        std::size_t forward = detail::rfind_byte(p.data() + from, p.size() - from, '/');
+        int i = (int) (forward != std::string::npos ? from + forward + 1 : from);
+
+        head = pystring::slice_view(p,0,i);
+        tail = pystring::slice_view(p,i); // now tail has no slashes
+        
+        // remove trailing slashes from head, unless it's all slashes
+        std::string_view head2 = head;
+        while(!head2.empty() && ((pystring::slice_view(head2,-1) == forward_slash) ||
+                                 (pystring::slice_view(head2,-1) == double_back_slash)))
         {
-            return std::string(str);
+            head2 = pystring::slice_view(head2,0,-1);
         }
+        
+        if(!head2.empty()) head.resize(head2.size());
+        head = d + head;
+    }
 
-        std::string s( str );
-
-        int fill = width - len;
 
-        s = std::string( fill, '0' ) + s;
+    // Split a path in head (everything up to the last '/') and tail (the
+    // rest).  If the path ends in '/', tail will be empty.  If there is no
+    // '/' in the path, head  will be empty.
+    // Trailing '/'es are stripped from head unless it is the root.
 
+    PYSTRING_INLINE void split_posix(std::string & head, std::string & tail, std::string_view p)
+    {
+        partition_result parts = detail::rpartition_bytes(p, forward_slash);
+        std::string_view headview = p.substr(0, parts.head.size() + parts.sep.size());
 
-        if ( s[fill] == '+' || s[fill] == '-' )
+        // Strip trailing slashes unless head is nothing but slashes
+        if(headview.find_first_not_of('/') != std::string_view::npos)
         {
-            s[0] = s[fill];
-            s[fill] = '0';
+            headview = headview.substr(0, headview.find_last_not_of('/') + 1);
         }
 
-        return s;
-
+        head = headview;
+        tail = parts.tail;
     }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string ljust( std::string_view str, int width )
+    PYSTRING_INLINE void split(std::string & head, std::string & tail, std::string_view path)
     {
-        std::string::size_type len = str.size();
-        if ( (( int ) len ) >= width ) return std::string(str);
-        return std::string(str) + std::string( width - len, ' ' );
+#ifdef WINDOWS
+        return split_nt(head, tail, path);
+#else
+        return split_posix(head, tail, path);
+#endif
     }
 
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string rjust( std::string_view str, int width )
+
+    PYSTRING_INLINE std::string basename_nt(std::string_view path)
     {
-        std::string::size_type len = str.size();
-        if ( (( int ) len ) >= width ) return std::string(str);
-        return std::string( width - len, ' ' ) + std::string(str);
+        std::string head, tail;
+        split_nt(head, tail, path);
+        return tail;
     }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string center( std::string_view str, int width )
+    PYSTRING_INLINE std::string basename_posix(std::string_view path)
     {
-        int len = (int) str.size();
-        int marg, left;
-
-        if ( len >= width ) return std::string(str);
-
-        marg = width - len;
-        left = marg / 2 + (marg & width & 1);
-
-        return std::string( left, ' ' ) + std::string(str) + std::string( marg - left, ' ' );
+        std::string head, tail;
+        split_posix(head, tail, path);
+        return tail;
+    }
 
+    PYSTRING_INLINE std::string basename(std::string_view path)
+    {
+#ifdef WINDOWS
+        return basename_nt(path);
+#else
+        return basename_posix(path);
+#endif
     }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string slice( std::string_view str, int start, int end )
+    PYSTRING_INLINE std::string dirname_nt(std::string_view path)
     {
-        ADJUST_INDICES(start, end, (int) str.size());
-        if ( start >= end ) return empty_string;
-        return std::string(str.substr( start, end - start ));
+        std::string head, tail;
+        split_nt(head, tail, path);
+        return head;
     }
     
+    PYSTRING_INLINE std::string dirname_posix(std::string_view path)
+    {
+        std::string head, tail;
+        split_posix(head, tail, path);
+        return head;
+    }
     
+    PYSTRING_INLINE std::string dirname(std::string_view path)
+    {
+#ifdef WINDOWS
+        return dirname_nt(path);
+#else
+        return dirname_posix(path);
+#endif
+    }
+
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    int find( std::string_view str, std::string_view sub, int start, int end  )
+
+    // Normalize a path, e.g. A//B, A/./B and A/foo/../B all become A\B.
+    PYSTRING_INLINE std::string normpath_nt(std::string_view p)
     {
-        ADJUST_INDICES(start, end, (int) str.size());
+        std::string path = std::string(p);
+        path = pystring::replace(path, forward_slash,double_back_slash);
+        
+        std::string prefix;
+        splitdrive_nt(prefix, path, path);
+        
+        // We need to be careful here. If the prefix is empty, and the path starts
+        // with a backslash, it could either be an absolute path on the current
+        // drive (\dir1\dir2\file) or a UNC filename (\\server\mount\dir1\file). It
+        // is therefore imperative NOT to collapse multiple backslashes blindly in
+        // that case.
+        // The code below preserves multiple backslashes when there is no drive
+        // letter. This means that the invalid filename \\\a\b is preserved
+        // unchanged, where a\\\b is normalised to a\b. It's not clear that there
+        // is any better behaviour for such edge cases.
+        
+        if(prefix.empty())
+        {
+            // No drive letter - preserve initial backslashes
+            while(pystring::slice(path,0,1) == double_back_slash)
+            {
+                prefix = prefix + double_back_slash;
+                path = pystring::slice(path,1);
+            }
+        }
+        else
+        {
+            // We have a drive letter - collapse initial backslashes
+            if(pystring::startswith(path, double_back_slash))
+            {
+                prefix = prefix + double_back_slash;
+                path = pystring::lstrip(path, double_back_slash);
+            }
+        }
+        
+        std::vector<std::string> comps;
+        pystring::split(path, comps, double_back_slash);
+        
+        int i = 0;
         
-        std::string::size_type result = str.find( sub, start );
+        while(i<(int)comps.size())
+        {
+            if(comps[i].empty() || comps[i] == dot)
+            {
+                comps.erase(comps.begin()+i);
+            }
+            else if(comps[i] == double_dot)
+            {
+                if(i>0 && comps[i-1] != double_dot)
+                {
+                    comps.erase(comps.begin()+i-1, comps.begin()+i+1);
+                    i -= 1;
+                }
+                else if(i == 0 && pystring::endswith(prefix, double_back_slash))
+                {
+                    comps.erase(comps.begin()+i);
+                }
+                else
+                {
+                    i += 1;
+                }
+            }
+            else
+            {
+                i += 1;
+            }
+        }
         
-        // If we cannot find the string, or if the end-point of our found substring is past
-        // the allowed end limit, return that it can't be found.
-        if( result == std::string::npos || 
-           (result + sub.size() > (std::string::size_type)end) )
+        // If the path is now empty, substitute '.'
+        if(prefix.empty() && comps.empty())
         {
-            return -1;
+            comps.push_back(dot);
         }
         
-        return (int) result;
+        return prefix + pystring::join(double_back_slash, comps);
     }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    int index( std::string_view str, std::string_view sub, int start, int end  )
-    {
-        return find( str, sub, start, end );
-    }
+    // Normalize a path, e.g. A//B, A/./B and A/foo/../B all become A/B.
+    // It should be understood that this may change the meaning of the path
+    // if it contains symbolic links!
+    // Normalize path, eliminating double slashes, etc.
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    int rfind( std::string_view str, std::string_view sub, int start, int end )
+    PYSTRING_INLINE std::string normpath_posix(std::string_view p)
     {
-        ADJUST_INDICES(start, end, (int) str.size());
+        if(p.empty()) return dot;
+        
+        std::string path = std::string(p);
+        
+        int initial_slashes = pystring::startswith(path, forward_slash) ? 1 : 0;
+        
+        // POSIX allows one or two initial slashes, but treats three or more
+        // as single slash.
+        
+        if (initial_slashes && pystring::startswith(path, double_forward_slash)
+            && !pystring::startswith(path, triple_forward_slash))
+            initial_slashes = 2;
+        
+        std::vector<std::string> comps, new_comps;
+        pystring::split(path, comps, forward_slash);
+        
+        for(unsigned int i=0; i<comps.size(); ++i)
+        {
+            std::string comp = comps[i];
+            if(comp.empty() || comp == dot)
+                continue;
+            
+            if( (comp != double_dot) || ((initial_slashes == 0) && new_comps.empty()) ||
+                (!new_comps.empty() && new_comps[new_comps.size()-1] == double_dot))
+            {
+                new_comps.push_back(comp);
+            }
+            else if (!new_comps.empty())
+            {
+                new_comps.pop_back();
+            }
+        }
         
-        std::string::size_type result = str.rfind( sub, end );
+        path = pystring::join(forward_slash, new_comps);
         
-        if( result == std::string::npos || 
-            result < (std::string::size_type)start  || 
-           (result + sub.size() > (std::string::size_type)end))
-            return -1;
+        if (initial_slashes > 0)
+            path = pystring::mul(forward_slash, initial_slashes) + path;
         
-        return (int)result;
+        if(path.empty()) return dot;
+        return path;
     }
-
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    int rindex( std::string_view str, std::string_view sub, int start, int end )
+    
+    PYSTRING_INLINE std::string normpath(std::string_view path)
     {
-        return rfind( str, sub, start, end );
+#ifdef WINDOWS
+        return normpath_nt(path);
+#else
+        return normpath_posix(path);
+#endif
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string expandtabs( std::string_view str, int tabsize )
-    {
-        std::string s( str );
-
-        std::string::size_type len = str.size(), i = 0;
-        int offset = 0;
 
-        int j = 0;
+    // Split the extension from a pathname.
+    // Extension is everything from the last dot to the end, ignoring
+    // leading dots.  Returns "(root, ext)"; ext may be empty.
+    // It is always true that root + ext == p
 
-        for ( i = 0; i < len; ++i )
+    PYSTRING_INLINE void splitext_generic(std::string & root, std::string & ext,
+                          std::string_view p,
+                          std::string_view sep,
+                          std::string_view altsep,
+                          std::string_view extsep)
+    {
+        Py_ssize_t sepIndex = pystring::rfind_64(p, sep);
+        if(!altsep.empty())
         {
-            if ( str[i] == '\t' )
-            {
-
-                if ( tabsize > 0 )
-                {
-                    int fillsize = tabsize - (j % tabsize);
-                    j += fillsize;
-                    s.replace( i + offset, 1, std::string( fillsize, ' ' ));
-                    offset += fillsize - 1;
-                }
-                else
-                {
-                    s.replace( i + offset, 1, empty_string );
-                    offset -= 1;
-                }
+            sepIndex = std::max(sepIndex, pystring::rfind_64(p, altsep));
+        }
 
-            }
-            else
+        partition_result parts = detail::rpartition_bytes(p, extsep);
+        Py_ssize_t dotIndex = parts.sep.empty() ? -1 : (Py_ssize_t) parts.head.size();
+        if(dotIndex > sepIndex)
+        {
+            // Skip all leading dots
+            std::string_view filename = p.substr(sepIndex + 1, dotIndex - sepIndex - 1);
+            if(filename.find_first_not_of(extsep) != std::string_view::npos)
             {
-                j++;
-
-                if (str[i] == '\n' || str[i] == '\r')
-                {
-                    j = 0;
-                }
+                root = parts.head;
+                ext = p.substr(dotIndex);
+                return;
             }
         }
 
-        return s;
+        root = p;
+        ext = empty_string;
     }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    int count( std::string_view str, std::string_view substr, int start, int end )
+    PYSTRING_INLINE void splitext_nt(std::string & root, std::string & ext, std::string_view path)
     {
-        int nummatches = 0;
-        int cursor = start;
-
-        while ( 1 )
-        {
-            cursor = find( str, substr, cursor, end );
-
-            if ( cursor < 0 ) break;
-
-            cursor += (int) substr.size();
-            nummatches += 1;
-        }
-
-        return nummatches;
-
+        return splitext_generic(root, ext, path,
+                                double_back_slash, forward_slash, dot);
+    }
 
+    PYSTRING_INLINE void splitext_posix(std::string & root, std::string & ext, std::string_view path)
+    {
+        return splitext_generic(root, ext, path,
+                                forward_slash, empty_string, dot);
     }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    
-    std::string replace( std::string_view str, std::string_view oldstr, std::string_view newstr, int count )
+    PYSTRING_INLINE void splitext(std::string & root, std::string & ext, std::string_view path)
     {
-        int sofar = 0;
-        int cursor = 0;
-        std::string s( str );
+#ifdef WINDOWS
+        return splitext_nt(root, ext, path);
+#else
+        return splitext_posix(root, ext, path);
+#endif
+    }
 
-        std::string::size_type oldlen = oldstr.size(), newlen = newstr.size();
-        
-        cursor = find( s, oldstr, cursor );
+} // namespace path
+} // namespace os
 
-        while ( cursor != -1 && cursor <= (int)s.size() )
+namespace batch
+{
+    namespace detail
+    {
+        using namespace pystring::detail;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// Run kernel( str, result ) for each string, sealing one result string per input. The
+        /// column is sized up front from bytes_hint, the expected total output length.
+        ///
+        template< typename Offset, typename Kernel >
+        bool run_batch( const StringSpan & strs, BasicStringColumn< Offset > & result, std::size_t bytes_hint, Kernel kernel )
         {
-            if ( count > -1 && sofar >= count )
+            result.clear();
+            result.reserve( strs.size(), bytes_hint );
+            for ( std::size_t i = 0; i < strs.size(); ++i )
             {
-                break;
+                kernel( strs[i], result );
+                if ( !result.seal() )
+                {
+                    result.clear();
+                    return false;
+                }
             }
+            return true;
+        }
 
-            s.replace( cursor, oldlen, newstr );
-            cursor += (int) newlen;
+        template< typename Offset >
+        inline void write( BasicStringColumn< Offset > & result, std::string_view bytes )
+        {
+            if ( !bytes.empty() ) result.extend( bytes );
+        }
 
-            if ( oldlen != 0)
+        template< typename Offset >
+        bool strip_batch( const StringSpan & strs, BasicStringColumn< Offset > & result, std::string_view chars )
+        {
+            if ( !chars.empty() )
             {
-                cursor = find( s, oldstr, cursor );
+                // Build the set once for the whole batch rather than once per string.
+                CharSet set( chars );
+                return run_batch( strs, result, strs.total_bytes(), [&set]( std::string_view str, BasicStringColumn< Offset > & out )
+                {
+                    write( out, do_strip_view( str, string_strip_direction_::bothstrip, set ) );
+                } );
             }
-            else
+            return run_batch( strs, result, strs.total_bytes(), []( std::string_view str, BasicStringColumn< Offset > & out )
             {
-                ++cursor;
-            }
+                write( out, do_strip_view( str, string_strip_direction_::bothstrip, std::string_view() ) );
+            } );
+        }
 
-            ++sofar;
+        template< typename Offset >
+        bool lower_batch( const StringSpan & strs, BasicStringColumn< Offset > & result )
+        {
+            return run_batch( strs, result, strs.total_bytes(), []( std::string_view str, BasicStringColumn< Offset > & out )
+            {
+                if ( str.empty() ) return;
+                detail::lower_bytes( out.extend( str ), str.size() );
+            } );
         }
 
-        return s;
+        template< typename Offset >
+        bool replace_batch( const StringSpan & strs, BasicStringColumn< Offset > & result,
+                            std::string_view oldstr, std::string_view newstr, int count )
+        {
+            // Output only grows past the input when newstr is longer; the column grows as needed.
+            return run_batch( strs, result, strs.total_bytes(), [&]( std::string_view str, BasicStringColumn< Offset > & out )
+            {
+                // Equal lengths: copy the string once and overwrite each hit in place.
+                if ( oldstr.size() == newstr.size() && !oldstr.empty() )
+                {
+                    if ( str.empty() ) return;
+                    char * dst = out.extend( str );
+                    if ( oldstr.size() == 1 && count < 0 )
+                    {
+                        // A plain byte swap, which the compiler vectorizes.
+                        const char from = oldstr[0], to = newstr[0];
+                        for ( std::size_t i = 0; i < str.size(); ++i ) dst[i] = dst[i] == from ? to : dst[i];
+                        return;
+                    }
 
-    }
-    
-    
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    void splitlines(  std::string_view str, std::vector< std::string > & result, bool keepends )
-    {
-        result.clear();
-        std::string::size_type len = str.size(), i, j, eol;
+                    std::size_t limit = count < 0 ? std::string_view::npos : (std::size_t) count;
+                    std::size_t pos = 0;
+                    for ( std::size_t done = 0; done < limit; ++done, pos += oldstr.size() )
+                    {
+                        pos = str.find( oldstr, pos );
+                        if ( pos == std::string_view::npos ) break;
+                        memcpy( dst + pos, newstr.data(), newstr.size() );
+                    }
+                    return;
+                }
 
-         for (i = j = 0; i < len; )
-         {
-            while (i < len && str[i] != '\n' && str[i] != '\r') i++;
+                // Otherwise size the result first, then write every piece through one pointer.
+                std::size_t n = 0;
+                replace_pieces( str, oldstr, newstr, count, [&n]( std::string_view piece ) { n += piece.size(); } );
+                if ( !n ) return;
+                char * dst = out.extend( n );
+                replace_pieces( str, oldstr, newstr, count, [&dst]( std::string_view piece )
+                {
+                    if ( piece.empty() ) return;
+                    memcpy( dst, piece.data(), piece.size() );
+                    dst += piece.size();
+                } );
+            } );
+        }
 
-            eol = i;
-            if (i < len)
+        template< typename Offset >
+        bool zfill_batch( const StringSpan & strs, BasicStringColumn< Offset > & result, int width )
+        {
+            std::size_t w = width > 0 ? (std::size_t) width : 0;
+            return run_batch( strs, result, strs.total_bytes() + strs.size() * w, [w]( std::string_view str, BasicStringColumn< Offset > & out )
             {
-                if (str[i] == '\r' && i + 1 < len && str[i+1] == '\n')
+                if ( str.size() >= w )
                 {
-                    i += 2;
+                    write( out, str );
+                    return;
                 }
-                else
+
+                std::size_t fill = w - str.size();
+                char * dst = out.extend( w );
+                memset( dst, '0', fill );
+                memcpy( dst + fill, str.data(), str.size() );
+                if ( !str.empty() && ( str[0] == '+' || str[0] == '-' ) )
                 {
-                    i++;
+                    dst[0] = str[0];
+                    dst[fill] = '0';
                 }
-                if (keepends)
-                eol = i;
+            } );
+        }
 
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// normpath_posix on views: the surviving components are kept in comps, which the
+        /// caller reuses across paths.
+        ///
+        template< typename Offset >
+        void normpath_posix_into( std::string_view path, BasicStringColumn< Offset > & out, small_vector_base< std::string_view > & comps )
+        {
+            if ( path.empty() )
+            {
+                write( out, dot );
+                return;
             }
 
-            result.push_back(std::string( str.substr( j, eol - j ) ));
-            j = i;
+            // POSIX allows one or two initial slashes, but treats three or more as a single one.
+            std::size_t initial_slashes = 0;
+            if ( path[0] == '/' )
+            {
+                initial_slashes = path.size() > 1 && path[1] == '/' && !( path.size() > 2 && path[2] == '/' ) ? 2 : 1;
+            }
 
-        }
+            comps.clear();
+            std::size_t pos = 0;
+            while ( pos <= path.size() )
+            {
+                std::size_t slash = path.find( '/', pos );
+                if ( slash == std::string_view::npos ) slash = path.size();
+                std::string_view comp = path.substr( pos, slash - pos );
+                pos = slash + 1;
 
-        if (j < len)
-        {
-            result.push_back(std::string( str.substr( j, len - j ) ));
-        }
+                if ( comp.empty() || comp == dot ) continue;
 
-    }
+                if ( comp != double_dot || ( initial_slashes == 0 && comps.empty() ) ||
+                     ( !comps.empty() && comps.back() == double_dot ) )
+                {
+                    comps.push_back( comp );
+                }
+                else if ( !comps.empty() )
+                {
+                    comps.pop_back();
+                }
+            }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string mul( std::string_view str, int n )
-    {
-        // Early exits
-        if (n <= 0) return empty_string;
-        if (n == 1) return std::string(str);
-        
-        std::ostringstream os;
-        for(int i=0; i<n; ++i)
-        {
-            os << str;
+            if ( initial_slashes == 0 && comps.empty() )
+            {
+                write( out, dot );
+                return;
+            }
+
+            write( out, std::string_view( "//", initial_slashes ) );
+            for ( std::size_t i = 0; i < comps.size(); ++i )
+            {
+                if ( i ) *out.extend( 1 ) = '/';
+                write( out, comps[i] );
+            }
         }
-        return os.str();
-    }
 
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
-    std::string removeprefix( std::string_view str, std::string_view prefix )
-    {
-        if (pystring::startswith(str, prefix))
+        template< typename Offset >
+        bool normpath_batch( const StringSpan & paths, BasicStringColumn< Offset > & result )
         {
-            return std::string(str.substr(prefix.length()));
+#ifdef WINDOWS
+            return run_batch( paths, result, paths.total_bytes(), []( std::string_view path, BasicStringColumn< Offset > & out )
+            {
+                write( out, os::path::normpath_nt( path ) );
+            } );
+#else
+            small_vector< std::string_view, 16 > comps;
+            return run_batch( paths, result, paths.total_bytes(), [&comps]( std::string_view path, BasicStringColumn< Offset > & out )
+            {
+                normpath_posix_into( path, out, comps );
+            } );
+#endif
         }
 
-        return std::string(str);
-    }
+        template< typename Offset >
+        bool basename_batch( const StringSpan & paths, BasicStringColumn< Offset > & result )
+        {
+            return run_batch( paths, result, paths.total_bytes(), []( std::string_view path, BasicStringColumn< Offset > & out )
+            {
+#ifdef WINDOWS
+                write( out, os::path::basename_nt( path ) );
+#else
+                write( out, rpartition_bytes( path, forward_slash ).tail );
+#endif
+            } );
+        }
+    } // namespace detail
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    std::string removesuffix( std::string_view str, std::string_view suffix )
+    PYSTRING_INLINE std::size_t StringSpan::total_bytes() const
     {
-        if (pystring::endswith(str, suffix))
-        {
-            return std::string(str.substr(0, str.length() - suffix.length()));
-        }
+        if ( !m_views ) return m_size ? (std::size_t) ( m_offsets32 ? m_offsets32[m_size] : m_offsets64[m_size] ) : 0;
 
-        return std::string(str);
+        std::size_t total = 0;
+        for ( std::size_t i = 0; i < m_size; ++i ) total += m_views[i].size();
+        return total;
     }
-
-
-namespace os
-{
-namespace path
-{
-    
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    /// These functions are C++ ports of the python2.6 versions of os.path,
-    /// and come from genericpath.py, ntpath.py, posixpath.py
+    PYSTRING_INLINE bool strip( const StringSpan & strs, StringColumn & result, std::string_view chars )
+    {
+        return detail::strip_batch( strs, result, chars );
+    }
 
-    /// Split a pathname into drive and path specifiers.
-    /// Returns drivespec, pathspec. Either part may be empty.
-    void splitdrive_nt(std::string & drivespec, std::string & pathspec,
-                       std::string_view p)
+    PYSTRING_INLINE bool strip( const StringSpan & strs, LargeStringColumn & result, std::string_view chars )
     {
-        if (p.size() >= 2 && p[1] == ':')
-        {
-            std::string path = std::string(p); // In case drivespec == p
-            drivespec = pystring::slice(path, 0, 2);
-            pathspec = pystring::slice(path, 2);
-        }
-        else
-        {
-            drivespec = empty_string;
-            pathspec = p;
-        }
+        return detail::strip_batch( strs, result, chars );
     }
 
-    // On Posix, drive is always empty
-    void splitdrive_posix(std::string & drivespec, std::string & pathspec,
-                          std::string_view path)
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool lower( const StringSpan & strs, StringColumn & result )
     {
-        drivespec = empty_string;
-        pathspec = path;
+        return detail::lower_batch( strs, result );
     }
 
-    void splitdrive(std::string & drivespec, std::string & pathspec,
-                    std::string_view path)
+    PYSTRING_INLINE bool lower( const StringSpan & strs, LargeStringColumn & result )
     {
-#ifdef WINDOWS
-        return splitdrive_nt(drivespec, pathspec, path);
-#else
-        return splitdrive_posix(drivespec, pathspec, path);
-#endif
+        return detail::lower_batch( strs, result );
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-
-    // Test whether a path is absolute
-    // In windows, if the character to the right of the colon
-    // is a forward or backslash it's absolute.
-    bool isabs_nt(std::string_view path)
+    PYSTRING_INLINE bool replace( const StringSpan & strs, StringColumn & result, std::string_view oldstr, std::string_view newstr, int count )
     {
-        std::string drivespec, pathspec;
-        splitdrive_nt(drivespec, pathspec, path);
-        if(pathspec.empty()) return false;
-        return ((pathspec[0] == '/') || (pathspec[0] == '\\'));
+        return detail::replace_batch( strs, result, oldstr, newstr, count );
     }
 
-    bool isabs_posix(std::string_view s)
+    PYSTRING_INLINE bool replace( const StringSpan & strs, LargeStringColumn & result, std::string_view oldstr, std::string_view newstr, int count )
     {
-        return pystring::startswith(s, forward_slash);
+        return detail::replace_batch( strs, result, oldstr, newstr, count );
     }
 
-    bool isabs(std::string_view path)
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool zfill( const StringSpan & strs, StringColumn & result, int width )
     {
-#ifdef WINDOWS
-        return isabs_nt(path);
-#else
-        return isabs_posix(path);
-#endif
+        return detail::zfill_batch( strs, result, width );
     }
 
+    PYSTRING_INLINE bool zfill( const StringSpan & strs, LargeStringColumn & result, int width )
+    {
+        return detail::zfill_batch( strs, result, width );
+    }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-    
-    std::string abspath_nt(std::string_view path, std::string_view cwd)
-    {
-        std::string p = std::string(path);
-        if(!isabs_nt(p)) p = join_nt(cwd, p);
-        return normpath_nt(p);
-    }
-    
-    std::string abspath_posix(std::string_view path, std::string_view cwd)
+    PYSTRING_INLINE bool normpath( const StringSpan & paths, StringColumn & result )
     {
-        std::string p = std::string(path);
-        if(!isabs_posix(p)) p = join_posix(cwd, p);
-        return normpath_posix(p);
+        return detail::normpath_batch( paths, result );
     }
-    
-    std::string abspath(std::string_view path, std::string_view cwd)
+
+    PYSTRING_INLINE bool normpath( const StringSpan & paths, LargeStringColumn & result )
     {
-#ifdef WINDOWS
-        return abspath_nt(path, cwd);
-#else
-        return abspath_posix(path, cwd);
-#endif
+        return detail::normpath_batch( paths, result );
     }
-    
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
+    PYSTRING_INLINE bool basename( const StringSpan & paths, StringColumn & result )
+    {
+        return detail::basename_batch( paths, result );
+    }
 
-    std::string join_nt(const std::vector< std::string > & paths)
+    PYSTRING_INLINE bool basename( const StringSpan & paths, LargeStringColumn & result )
     {
-        if(paths.empty()) return empty_string;
-        if(paths.size() == 1) return paths[0];
-        
-        std::string path = paths[0];
-        
-        for(unsigned int i=1; i<paths.size(); ++i)
+        return detail::basename_batch( paths, result );
+    }
+
+} // namespace batch
+
+namespace utf8
+{
+    namespace detail
+    {
+        using namespace pystring::detail;
+        using namespace pystring::unicode_data;
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Decode the UTF-8 sequence at the start of s into cp. Returns the number of bytes
+        /// consumed, or 0 for an invalid, overlong, surrogate or truncated sequence.
+        ///
+        PYSTRING_INLINE std::size_t decode( const char * s, std::size_t len, char32_t & cp )
         {
-            std::string b = paths[i];
-            
-            bool b_nts = false;
-            if(path.empty())
-            {
-                b_nts = true;
-            }
-            else if(isabs_nt(b))
-            {
-                // This probably wipes out path so far.  However, it's more
-                // complicated if path begins with a drive letter:
-                //     1. join('c:', '/a') == 'c:/a'
-                //     2. join('c:/', '/a') == 'c:/a'
-                // But
-                //     3. join('c:/a', '/b') == '/b'
-                //     4. join('c:', 'd:/') = 'd:/'
-                //     5. join('c:/', 'd:/') = 'd:/'
-                
+            const unsigned char * u = (const unsigned char *) s;
+            unsigned char c = u[0];
 
-                if ((path.size() >= 2 && path[1] != ':') || (b.size() >= 2 && b[1] == ':'))
-                {
-                    // Path doesnt start with a drive letter
-                    b_nts = true;
-                }
-                // Else path has a drive letter, and b doesn't but is absolute.
-                else if((path.size()>3) || 
-                        ((path.size()==3) && !pystring::endswith(path, forward_slash) && !pystring::endswith(path, double_back_slash)))
-                {
-                    b_nts = true;
-                }
-            }
-            
-            if(b_nts)
-            {
-                path = b;
-            }
-            else
+            if ( c < 0x80 ) { cp = c; return 1; }
+
+            std::size_t n;
+            char32_t min;
+            if ( ( c & 0xE0 ) == 0xC0 ) { n = 2; cp = c & 0x1F; min = 0x80; }
+            else if ( ( c & 0xF0 ) == 0xE0 ) { n = 3; cp = c & 0x0F; min = 0x800; }
+            else if ( ( c & 0xF8 ) == 0xF0 ) { n = 4; cp = c & 0x07; min = 0x10000; }
+            else return 0;
+
+            if ( n > len ) return 0;
+
+            for ( std::size_t i = 1; i < n; ++i )
             {
-                // Join, and ensure there's a separator.
-                // assert len(path) > 0
-                if( pystring::endswith(path, forward_slash) || pystring::endswith(path, double_back_slash))
-                {
-                    if(pystring::startswith(b,forward_slash) || pystring::startswith(b,double_back_slash))
-                    {
-                        path += pystring::slice(b, 1);
-                    }
-                    else
-                    {
-                        path += b;
-                    }
-                }
-                else if(pystring::endswith(path, colon))
-                {
-                    path += b;
-                }
-                else if(!b.empty())
-                {
-                    if(pystring::startswith(b, forward_slash) || pystring::startswith(b,double_back_slash))
-                    {
-                        path += b;
-                    }
-                    else
-                    {
-                        path += double_back_slash + b;
-                    }
-                }
-                else
-                {
-                    // path is not empty and does not end with a backslash,
-                    // but b is empty; since, e.g., split('a/') produces
-                    // ('a', ''), it's best if join() adds a backslash in
-                    // this case.
-                    path += double_back_slash;
-                }
+                if ( ( u[i] & 0xC0 ) != 0x80 ) return 0;
+                cp = ( cp << 6 ) | ( u[i] & 0x3F );
             }
-        }
-        
-        return path;
-    }
-    
-    // Join two or more pathname components, inserting double_back_slash as needed.
-    std::string join_nt(std::string_view a, std::string_view b)
-    {
-        std::vector< std::string > paths(2);
-        paths[0] = a;
-        paths[1] = b;
-        return join_nt(paths);
-    }
 
-    // Join pathnames.
-    // If any component is an absolute path, all previous path components
-    // will be discarded.
-    // Ignore the previous parts if a part is absolute.
-    // Insert a '/' unless the first part is empty or already ends in '/'.
+            if ( cp < min || cp > 0x10FFFF || ( cp >= 0xD800 && cp <= 0xDFFF ) ) return 0;
+            return n;
+        }
 
-    std::string join_posix(const std::vector< std::string > & paths)
-    {
-        if(paths.empty()) return empty_string;
-        if(paths.size() == 1) return paths[0];
-        
-        std::string path = paths[0];
-        
-        for(unsigned int i=1; i<paths.size(); ++i)
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        ///
+        ///
+        PYSTRING_INLINE void encode( std::string & out, char32_t cp )
         {
-            std::string b = paths[i];
-            if(pystring::startswith(b, forward_slash))
+            if ( cp < 0x80 )
             {
-                path = b;
+                out += (char) cp;
             }
-            else if(path.empty() || pystring::endswith(path, forward_slash))
+            else if ( cp < 0x800 )
             {
-                path += b;
+                out += (char) ( 0xC0 | ( cp >> 6 ) );
+                out += (char) ( 0x80 | ( cp & 0x3F ) );
+            }
+            else if ( cp < 0x10000 )
+            {
+                out += (char) ( 0xE0 | ( cp >> 12 ) );
+                out += (char) ( 0x80 | ( ( cp >> 6 ) & 0x3F ) );
+                out += (char) ( 0x80 | ( cp & 0x3F ) );
             }
             else
             {
-                path += forward_slash + b;
+                out += (char) ( 0xF0 | ( cp >> 18 ) );
+                out += (char) ( 0x80 | ( ( cp >> 12 ) & 0x3F ) );
+                out += (char) ( 0x80 | ( ( cp >> 6 ) & 0x3F ) );
+                out += (char) ( 0x80 | ( cp & 0x3F ) );
             }
         }
-        
-        return path;
-    }
 
-    std::string join_posix(std::string_view a, std::string_view b)
-    {
-        std::vector< std::string > paths(2);
-        paths[0] = a;
-        paths[1] = b;
-        return join_posix(paths);
-    }
-    
-    std::string join(std::string_view path1, std::string_view path2)
-    {
-#ifdef WINDOWS
-        return join_nt(path1, path2);
-#else
-        return join_posix(path1, path2);
-#endif
-    }
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Find the run in a table sorted by first that may contain cp, or nullptr.
+        ///
+        template< typename T, std::size_t N >
+        const T * lookup( const T (&table)[N], char32_t cp )
+        {
+            const T * it = std::upper_bound( table, table + N, cp,
+                                             []( char32_t c, const T & r ) { return c < r.first; } );
+            if ( it == table ) return nullptr;
+            --it;
+            if ( cp > it->last || ( cp - it->first ) % it->stride != 0 ) return nullptr;
+            return it;
+        }
 
+        template< std::size_t N >
+        bool in_ranges( const unicode_range (&table)[N], char32_t cp )
+        {
+            return lookup( table, cp ) != nullptr;
+        }
 
-    std::string join(const std::vector< std::string > & paths)
-    {
-#ifdef WINDOWS
-        return join_nt(paths);
-#else
-        return join_posix(paths);
-#endif
-    }
-    
-    //////////////////////////////////////////////////////////////////////////////////////////////
-    ///
-    ///
+        template< std::size_t N >
+        char32_t map_runs( const unicode_case_run (&table)[N], char32_t cp )
+        {
+            const unicode_case_run * run = lookup( table, cp );
+            return run ? (char32_t) ( (std::int32_t) cp + run->delta ) : cp;
+        }
 
-        
-    // Split a pathname.
-    // Return (head, tail) where tail is everything after the final slash.
-    // Either part may be empty
+        PYSTRING_INLINE bool cp_isupper( char32_t cp )
+        {
+            return cp < 0x80 ? is_upper( (char) cp ) : in_ranges( upper_ranges, cp );
+        }
 
-    void split_nt(std::string & head, std::string & tail, std::string_view path)
-    {
-        std::string d, p;
-        splitdrive_nt(d, p, path);
-        
-        // set i to index beyond p's last slash
-        int i = (int)p.size();
+        PYSTRING_INLINE bool cp_islower( char32_t cp )
+        {
+            return cp < 0x80 ? is_lower( (char) cp ) : in_ranges( lower_ranges, cp );
+        }
+
+        PYSTRING_INLINE bool cp_istitle( char32_t cp )
+        {
+            return cp >= 0x80 && in_ranges( title_ranges, cp );
+        }
+
+        PYSTRING_INLINE char32_t cp_lower( char32_t cp )
+        {
+            return cp < 0x80 ? (char32_t) to_lower( (char) cp ) : map_runs( to_lower_runs, cp );
+        }
+
+        PYSTRING_INLINE char32_t cp_upper( char32_t cp )
+        {
+            return cp < 0x80 ? (char32_t) to_upper( (char) cp ) : map_runs( to_upper_runs, cp );
+        }
+
+        PYSTRING_INLINE char32_t cp_title( char32_t cp )
+        {
+            if ( cp < 0x80 ) return (char32_t) to_upper( (char) cp );
+            const unicode_case_run * run = lookup( to_title_runs, cp );
+            return run ? (char32_t) ( (std::int32_t) cp + run->delta ) : map_runs( to_upper_runs, cp );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Shared driver for the case mappings: ASCII runs are copied in bulk and handed to the
+        /// byte kernel, only the non-ASCII code points are decoded and mapped one at a time.
+        /// Invalid bytes are passed through unchanged.
+        ///
+        template< typename ByteKernel, typename CodePointMap >
+        std::string map_string( std::string_view str, ByteKernel bytes, CodePointMap map )
+        {
+            std::string out;
+            out.reserve( str.size() );
+
+            const char * s = str.data();
+            std::size_t len = str.size(), i = 0;
+
+            while ( i < len )
+            {
+                std::size_t run = ascii_prefix_length( s + i, len - i );
+                if ( run )
+                {
+                    std::size_t start = out.size();
+                    out.append( s + i, run );
+                    bytes( &out[start], run );
+                    i += run;
+                    continue;
+                }
+
+                char32_t cp;
+                std::size_t n = decode( s + i, len - i, cp );
+                if ( n == 0 )
+                {
+                    out += s[i++];
+                    continue;
+                }
+
+                map( out, cp );
+                i += n;
+            }
 
-        // walk back to find the index of the first slash from the end       
-        while(i>0 && (p[i-1] != '\\') && (p[i-1] != '/'))
-        {
-            i = i - 1;
+            return out;
         }
 
-        head = pystring::slice(p,0,i);
-        tail = pystring::slice(p,i); // now tail has no slashes
-        
-        // remove trailing slashes from head, unless it's all slashes
-        std::string head2 = head;
-        while(!head2.empty() && ((pystring::slice(head2,-1) == forward_slash) ||
-                                 (pystring::slice(head2,-1) == double_back_slash)))
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Shared driver for the predicates: true if str is non-empty, valid, every ASCII run
+        /// passes the byte predicate and every other code point is in the property table.
+        ///
+        template< typename BytePredicate, typename CodePointPredicate >
+        bool all_of( std::string_view str, BytePredicate bytes, CodePointPredicate pred )
         {
-            head2 = pystring::slice(head2,0,-1);
+            const char * s = str.data();
+            std::size_t len = str.size(), i = 0;
+
+            if ( len == 0 ) return false;
+
+            while ( i < len )
+            {
+                std::size_t run = ascii_prefix_length( s + i, len - i );
+                if ( run )
+                {
+                    if ( !bytes( str.substr( i, run ) ) ) return false;
+                    i += run;
+                    continue;
+                }
+
+                char32_t cp;
+                std::size_t n = decode( s + i, len - i, cp );
+                if ( n == 0 || !pred( cp ) ) return false;
+                i += n;
+            }
+
+            return true;
         }
-        
-        if(!head2.empty()) head = head2;
-        head = d + head;
-    }
 
+        //////////////////////////////////////////////////////////////////////////////////////////////
+        /// Walk str one code point at a time, calling fn( cp ) and stopping early if it returns
+        /// false. Returns false on invalid input.
+        ///
+        template< typename Fn >
+        bool for_each_code_point( std::string_view str, Fn fn )
+        {
+            const char * s = str.data();
+            std::size_t len = str.size(), i = 0;
 
-    // Split a path in head (everything up to the last '/') and tail (the
-    // rest).  If the path ends in '/', tail will be empty.  If there is no
-    // '/' in the path, head  will be empty.
-    // Trailing '/'es are stripped from head unless it is the root.
+            while ( i < len )
+            {
+                char32_t cp;
+                std::size_t n = decode( s + i, len - i, cp );
+                if ( n == 0 ) return false;
+                if ( !fn( cp ) ) return false;
+                i += n;
+            }
+
+            return true;
+        }
+
+    } // namespace detail
 
-    void split_posix(std::string & head, std::string & tail, std::string_view p)
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE bool isvalid( std::string_view str )
     {
-        int i = pystring::rfind(p, forward_slash) + 1;
-        
-        head = pystring::slice(p,0,i);
-        tail = pystring::slice(p,i);
-        
-        if(!head.empty() && (head != pystring::mul(forward_slash, (int) head.size())))
+        const char * s = str.data();
+        std::size_t len = str.size(), i = 0;
+
+        while ( i < len )
         {
-            head = pystring::rstrip(head, forward_slash);
+            i += detail::ascii_prefix_length( s + i, len - i );
+            if ( i == len ) break;
+
+            char32_t cp;
+            std::size_t n = detail::decode( s + i, len - i, cp );
+            if ( n == 0 ) return false;
+            i += n;
         }
-    }
 
-    void split(std::string & head, std::string & tail, std::string_view path)
-    {
-#ifdef WINDOWS
-        return split_nt(head, tail, path);
-#else
-        return split_posix(head, tail, path);
-#endif
+        return true;
     }
 
-
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-
-    std::string basename_nt(std::string_view path)
+    PYSTRING_INLINE bool isalnum( std::string_view str )
     {
-        std::string head, tail;
-        split_nt(head, tail, path);
-        return tail;
+        return detail::all_of( str, []( std::string_view run ) { return pystring::isalnum( run ); },
+                       []( char32_t cp ) { return detail::in_ranges( detail::alpha_ranges, cp ) || detail::in_ranges( detail::digit_ranges, cp ); } );
     }
 
-    std::string basename_posix(std::string_view path)
+    PYSTRING_INLINE bool isalpha( std::string_view str )
     {
-        std::string head, tail;
-        split_posix(head, tail, path);
-        return tail;
+        return detail::all_of( str, []( std::string_view run ) { return pystring::isalpha( run ); },
+                       []( char32_t cp ) { return detail::in_ranges( detail::alpha_ranges, cp ); } );
     }
 
-    std::string basename(std::string_view path)
+    PYSTRING_INLINE bool isdigit( std::string_view str )
     {
-#ifdef WINDOWS
-        return basename_nt(path);
-#else
-        return basename_posix(path);
-#endif
+        return detail::all_of( str, []( std::string_view run ) { return pystring::isdigit( run ); },
+                       []( char32_t cp ) { return detail::in_ranges( detail::digit_ranges, cp ); } );
     }
 
-    std::string dirname_nt(std::string_view path)
+    PYSTRING_INLINE bool islower( std::string_view str )
     {
-        std::string head, tail;
-        split_nt(head, tail, path);
-        return head;
+        bool cased = false;
+
+        bool valid = detail::for_each_code_point( str, [&]( char32_t cp )
+        {
+            if ( detail::cp_isupper( cp ) || detail::cp_istitle( cp ) ) return false;
+            cased = cased || detail::cp_islower( cp );
+            return true;
+        } );
+
+        return valid && cased;
     }
-    
-    std::string dirname_posix(std::string_view path)
+
+    PYSTRING_INLINE bool isspace( std::string_view str )
     {
-        std::string head, tail;
-        split_posix(head, tail, path);
-        return head;
+        return detail::all_of( str, []( std::string_view run ) { return pystring::isspace( run ); },
+                       []( char32_t cp ) { return detail::in_ranges( detail::space_ranges, cp ); } );
     }
-    
-    std::string dirname(std::string_view path)
+
+    PYSTRING_INLINE bool isupper( std::string_view str )
     {
-#ifdef WINDOWS
-        return dirname_nt(path);
-#else
-        return dirname_posix(path);
-#endif
-    }
+        bool cased = false;
+
+        bool valid = detail::for_each_code_point( str, [&]( char32_t cp )
+        {
+            if ( detail::cp_islower( cp ) || detail::cp_istitle( cp ) ) return false;
+            cased = cased || detail::cp_isupper( cp );
+            return true;
+        } );
 
+        return valid && cased;
+    }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
-
-    // Normalize a path, e.g. A//B, A/./B and A/foo/../B all become A\B.
-    std::string normpath_nt(std::string_view p)
+    PYSTRING_INLINE bool istitle( std::string_view str )
     {
-        std::string path = std::string(p);
-        path = pystring::replace(path, forward_slash,double_back_slash);
-        
-        std::string prefix;
-        splitdrive_nt(prefix, path, path);
-        
-        // We need to be careful here. If the prefix is empty, and the path starts
-        // with a backslash, it could either be an absolute path on the current
-        // drive (\dir1\dir2\file) or a UNC filename (\\server\mount\dir1\file). It
-        // is therefore imperative NOT to collapse multiple backslashes blindly in
-        // that case.
-        // The code below preserves multiple backslashes when there is no drive
-        // letter. This means that the invalid filename \\\a\b is preserved
-        // unchanged, where a\\\b is normalised to a\b. It's not clear that there
-        // is any better behaviour for such edge cases.
-        
-        if(prefix.empty())
-        {
-            // No drive letter - preserve initial backslashes
-            while(pystring::slice(path,0,1) == double_back_slash)
-            {
-                prefix = prefix + double_back_slash;
-                path = pystring::slice(path,1);
-            }
-        }
-        else
-        {
-            // We have a drive letter - collapse initial backslashes
-            if(pystring::startswith(path, double_back_slash))
-            {
-                prefix = prefix + double_back_slash;
-                path = pystring::lstrip(path, double_back_slash);
-            }
-        }
-        
-        std::vector<std::string> comps;
-        pystring::split(path, comps, double_back_slash);
-        
-        int i = 0;
-        
-        while(i<(int)comps.size())
+        bool cased = false, previous_is_cased = false;
+
+        bool valid = detail::for_each_code_point( str, [&]( char32_t cp )
         {
-            if(comps[i].empty() || comps[i] == dot)
+            if ( detail::cp_isupper( cp ) || detail::cp_istitle( cp ) )
             {
-                comps.erase(comps.begin()+i);
+                if ( previous_is_cased ) return false;
+                previous_is_cased = cased = true;
             }
-            else if(comps[i] == double_dot)
+            else if ( detail::cp_islower( cp ) )
             {
-                if(i>0 && comps[i-1] != double_dot)
-                {
-                    comps.erase(comps.begin()+i-1, comps.begin()+i+1);
-                    i -= 1;
-                }
-                else if(i == 0 && pystring::endswith(prefix, double_back_slash))
-                {
-                    comps.erase(comps.begin()+i);
-                }
-                else
-                {
-                    i += 1;
-                }
+                if ( !previous_is_cased ) return false;
+                previous_is_cased = cased = true;
             }
             else
             {
-                i += 1;
+                previous_is_cased = false;
             }
-        }
-        
-        // If the path is now empty, substitute '.'
-        if(prefix.empty() && comps.empty())
-        {
-            comps.push_back(dot);
-        }
-        
-        return prefix + pystring::join(double_back_slash, comps);
-    }
-
-    // Normalize a path, e.g. A//B, A/./B and A/foo/../B all become A/B.
-    // It should be understood that this may change the meaning of the path
-    // if it contains symbolic links!
-    // Normalize path, eliminating double slashes, etc.
+            return true;
+        } );
 
-    std::string normpath_posix(std::string_view p)
-    {
-        if(p.empty()) return dot;
-        
-        std::string path = std::string(p);
-        
-        int initial_slashes = pystring::startswith(path, forward_slash) ? 1 : 0;
-        
-        // POSIX allows one or two initial slashes, but treats three or more
-        // as single slash.
-        
-        if (initial_slashes && pystring::startswith(path, double_forward_slash)
-            && !pystring::startswith(path, triple_forward_slash))
-            initial_slashes = 2;
-        
-        std::vector<std::string> comps, new_comps;
-        pystring::split(path, comps, forward_slash);
-        
-        for(unsigned int i=0; i<comps.size(); ++i)
-        {
-            std::string comp = comps[i];
-            if(comp.empty() || comp == dot)
-                continue;
-            
-            if( (comp != double_dot) || ((initial_slashes == 0) && new_comps.empty()) ||
-                (!new_comps.empty() && new_comps[new_comps.size()-1] == double_dot))
-            {
-                new_comps.push_back(comp);
-            }
-            else if (!new_comps.empty())
-            {
-                new_comps.pop_back();
-            }
-        }
-        
-        path = pystring::join(forward_slash, new_comps);
-        
-        if (initial_slashes > 0)
-            path = pystring::mul(forward_slash, initial_slashes) + path;
-        
-        if(path.empty()) return dot;
-        return path;
-    }
-    
-    std::string normpath(std::string_view path)
-    {
-#ifdef WINDOWS
-        return normpath_nt(path);
-#else
-        return normpath_posix(path);
-#endif
+        return valid && cased;
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///
+    PYSTRING_INLINE std::string lower( std::string_view str )
+    {
+        return detail::map_string( str, detail::lower_bytes,
+                           []( std::string & out, char32_t cp ) { detail::encode( out, detail::cp_lower( cp ) ); } );
+    }
 
-    // Split the extension from a pathname.
-    // Extension is everything from the last dot to the end, ignoring
-    // leading dots.  Returns "(root, ext)"; ext may be empty.
-    // It is always true that root + ext == p
+    PYSTRING_INLINE std::string upper( std::string_view str )
+    {
+        return detail::map_string( str, detail::upper_bytes,
+                           []( std::string & out, char32_t cp ) { detail::encode( out, detail::cp_upper( cp ) ); } );
+    }
 
-    void splitext_generic(std::string & root, std::string & ext,
-                          std::string_view p,
-                          std::string_view sep,
-                          std::string_view altsep,
-                          std::string_view extsep)
+    PYSTRING_INLINE std::string swapcase( std::string_view str )
     {
-        int sepIndex = pystring::rfind(p, sep);
-        if(!altsep.empty())
+        return detail::map_string( str, detail::swapcase_bytes, []( std::string & out, char32_t cp )
         {
-            int altsepIndex = pystring::rfind(p, altsep);
-            sepIndex = std::max(sepIndex, altsepIndex);
-        }
+            if ( detail::cp_isupper( cp ) ) cp = detail::cp_lower( cp );
+            else if ( detail::cp_islower( cp ) ) cp = detail::cp_upper( cp );
+            detail::encode( out, cp );
+        } );
+    }
 
-        int dotIndex = pystring::rfind(p, extsep);
-        if(dotIndex > sepIndex)
+    PYSTRING_INLINE std::string casefold( std::string_view str )
+    {
+        return detail::map_string( str, detail::lower_bytes, []( std::string & out, char32_t cp )
         {
-            // Skip all leading dots
-            int filenameIndex = sepIndex + 1;
+            const detail::unicode_fold_special * special = std::lower_bound(
+                std::begin( detail::fold_specials ), std::end( detail::fold_specials ), cp,
+                []( const detail::unicode_fold_special & f, char32_t c ) { return f.cp < c; } );
 
-            while(filenameIndex < dotIndex)
+            if ( special != std::end( detail::fold_specials ) && special->cp == cp )
             {
-                if(pystring::slice(p,filenameIndex) != extsep)
+                for ( char32_t to : special->to )
                 {
-                    root = pystring::slice(p, 0, dotIndex);
-                    ext = pystring::slice(p, dotIndex);
-                    return;
+                    if ( to ) detail::encode( out, to );
                 }
-
-                filenameIndex += 1;
+                return;
             }
-        }
 
-        root = p;
-        ext = empty_string;
+            const detail::unicode_case_run * run = detail::lookup( detail::fold_runs, cp );
+            detail::encode( out, run ? (char32_t) ( (std::int32_t) cp + run->delta ) : detail::cp_lower( cp ) );
+        } );
     }
 
-    void splitext_nt(std::string & root, std::string & ext, std::string_view path)
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///
+    PYSTRING_INLINE std::string title( std::string_view str )
     {
-        return splitext_generic(root, ext, path,
-                                double_back_slash, forward_slash, dot);
-    }
+        std::string out;
+        out.reserve( str.size() );
 
-    void splitext_posix(std::string & root, std::string & ext, std::string_view path)
-    {
-        return splitext_generic(root, ext, path,
-                                forward_slash, empty_string, dot);
-    }
+        const char * s = str.data();
+        std::size_t len = str.size(), i = 0;
+        bool previous_is_cased = false;
 
-    void splitext(std::string & root, std::string & ext, std::string_view path)
-    {
-#ifdef WINDOWS
-        return splitext_nt(root, ext, path);
-#else
-        return splitext_posix(root, ext, path);
-#endif
+        while ( i < len )
+        {
+            char32_t cp;
+            std::size_t n = detail::decode( s + i, len - i, cp );
+            if ( n == 0 )
+            {
+                out += s[i++];
+                previous_is_cased = false;
+                continue;
+            }
+
+            bool upper = detail::cp_isupper( cp ) || detail::cp_istitle( cp ), lower = detail::cp_islower( cp );
+
+            if ( lower && !previous_is_cased ) cp = detail::cp_title( cp );
+            else if ( upper && previous_is_cased ) cp = detail::cp_lower( cp );
+            else if ( upper ) cp = detail::cp_title( cp );
+
+            previous_is_cased = upper || lower;
+            detail::encode( out, cp );
+            i += n;
+        }
+
+        return out;
     }
 
-} // namespace path
-} // namespace os
+} // namespace utf8
 
 
 }//namespace pystring
 
+// In header-only mode this file is part of every translation unit including pystring.h, so
+// do not leak its private macros.
+#if defined(PYSTRING_HEADER_ONLY)
+#undef ADJUST_INDICES
+#if defined(PYSTRING_DEFINED_WINDOWS)
+#undef WINDOWS
+#undef PYSTRING_DEFINED_WINDOWS
+#endif
+#endif
 
+#endif
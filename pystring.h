@@ -6,10 +6,31 @@
 #ifndef INCLUDED_PYSTRING_H
 #define INCLUDED_PYSTRING_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <vector>
 
+// Define PYSTRING_HEADER_ONLY before including pystring.h (or link the pystring::header_only
+// CMake target) to compile the implementation into each translation unit as inline functions,
+// so calls can be inlined and constant folded instead of going through the shared library.
+#if defined(PYSTRING_HEADER_ONLY)
+#define PYSTRING_INLINE inline
+#else
+#define PYSTRING_INLINE
+#endif
+
 namespace pystring
 {
 
@@ -29,6 +50,61 @@ namespace pystring
 
 
     #define MAX_32BIT_INT 2147483647
+    #define MAX_PTRDIFF_T PTRDIFF_MAX
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A set of bytes, for the functions taking a list of characters (strip, split_any and
+    /// translate's deletechars). Membership is a bitmap lookup, so a set built once, possibly at
+    /// compile time, can be reused across any number of strings:
+    ///
+    ///     constexpr pystring::CharSet separators( ",;\t" );
+    ///
+    class CharSet
+    {
+    public:
+        constexpr CharSet() : m_bits(), m_members(), m_count( 0 ), m_rows() {}
+
+        explicit constexpr CharSet( std::string_view chars ) : CharSet()
+        {
+            for ( char c : chars ) insert( c );
+        }
+
+        constexpr void insert( char c )
+        {
+            unsigned char u = (unsigned char) c;
+            if ( contains( c ) ) return;
+            m_bits[u >> 6] |= std::uint64_t( 1 ) << ( u & 63 );
+            if ( m_count < 8 ) m_members[m_count] = u;
+            ++m_count;
+            m_rows[( u & 15 ) + ( u & 0x80 ? 16 : 0 )] |= (unsigned char) ( 1u << ( ( u >> 4 ) & 7 ) );
+        }
+
+        constexpr bool contains( char c ) const
+        {
+            unsigned char u = (unsigned char) c;
+            return ( m_bits[u >> 6] >> ( u & 63 ) ) & 1;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return the number of distinct bytes in the set.
+        ///
+        constexpr std::size_t size() const { return m_count; }
+        constexpr bool empty() const { return m_count == 0; }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Lookup data for the vectorized kernels: the first min( size(), 8 ) members, and
+        /// 32 nibble rows where bit hi & 7 of row lo (row 16 + lo for hi >= 8) is set when byte
+        /// hi << 4 | lo is a member.
+        ///
+        constexpr const unsigned char * members() const { return m_members; }
+        constexpr const unsigned char * nibble_rows() const { return m_rows; }
+
+    private:
+        std::uint64_t m_bits[4];
+        unsigned char m_members[8];
+        std::size_t m_count;
+        unsigned char m_rows[32];
+    };
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return a copy of the string with only its first character capitalized.
@@ -82,18 +158,42 @@ namespace pystring
     ///
     bool isalpha( std::string_view str );
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if the string is empty or all characters in the string are ASCII,
+    /// false otherwise.
+    ///
+    bool isascii( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all characters in the string are decimal characters and there is at
+    /// least one character, false otherwise. Only the ASCII digits are decimal characters.
+    ///
+    bool isdecimal( std::string_view str );
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return true if all characters in the string are digits and there is at least one
     /// character, false otherwise.
     ///
     bool isdigit( std::string_view str );
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if the string is a valid identifier: a letter or underscore followed
+    /// by letters, digits or underscores. Only ASCII identifiers are recognised.
+    ///
+    bool isidentifier( std::string_view str );
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return true if all cased characters in the string are lowercase and there is at least one
     /// cased character, false otherwise.
     ///
     bool islower( std::string_view str );
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all characters in the string are printable or the string is empty,
+    /// false otherwise. The printable characters are ASCII ' ' to '~'.
+    ///
+    bool isprintable( std::string_view str );
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return true if there are only whitespace characters in the string and there is at least
     /// one character, false otherwise.
@@ -137,6 +237,7 @@ namespace pystring
     /// is called on (argument "str" ).
     ///
     std::string lstrip( std::string_view str, std::string_view chars = "" );
+    std::string lstrip( std::string_view str, const CharSet & chars );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return a copy of the string, concatenated N times, together.
@@ -149,6 +250,7 @@ namespace pystring
     /// Three strings will always placed into result. If sep is found, the strings will
     /// be the text before sep, sep itself, and the remaining text. If sep is
     /// not found, the original string will be returned with two empty strings.
+    /// The strings already in result are assigned to, so their storage is reused.
     ///
     void partition( std::string_view str, std::string_view sep, std::vector< std::string > & result );
     inline std::vector< std::string > partition( std::string_view str, std::string_view sep )
@@ -200,6 +302,7 @@ namespace pystring
     /// Three strings will always placed into result. If sep is found, the strings will
     /// be the text before sep, sep itself, and the remaining text. If sep is
     /// not found, the original string will be returned with two empty strings.
+    /// The strings already in result are assigned to, so their storage is reused.
     ///
     void rpartition( std::string_view str, std::string_view sep, std::vector< std::string > & result );
     inline std::vector< std::string > rpartition ( std::string_view str, std::string_view sep )
@@ -215,6 +318,7 @@ namespace pystring
     /// end of the string this method is called on.
     ///
     std::string rstrip( std::string_view str, std::string_view chars = "" );
+    std::string rstrip( std::string_view str, const CharSet & chars );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Fills the "result" list with the words in the string, using sep as the delimiter string.
@@ -229,6 +333,13 @@ namespace pystring
         return result;
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Like split, but assigns the fields into the strings result already holds so their
+    /// storage is reused from one call to the next. result only grows when there are more
+    /// fields than it holds.
+    ///
+    void split_reuse( std::string_view str, std::vector< std::string > & result, std::string_view sep = "", int maxsplit = -1 );
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Fills the "result" list with the words in the string, using sep as the delimiter string.
     /// Does a number of splits starting at the end of the string, the result still has the
@@ -244,6 +355,51 @@ namespace pystring
         return result;
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Like rsplit, reusing the strings result already holds. See split_reuse.
+    ///
+    void rsplit_reuse( std::string_view str, std::vector< std::string > & result, std::string_view sep = "", int maxsplit = -1 );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a list of the fields in the string, treating any of the bytes in chars as a
+    /// separator, so split_any( "a,b;c", ",;" ) gives [ "a", "b", "c" ].
+    /// If maxsplit is > -1, at most maxsplit splits are done. If collapse is true, runs of
+    /// separators count as one and leading or trailing separators produce no empty fields,
+    /// the way split with sep "" treats whitespace.
+    ///
+    void split_any( std::string_view str, std::vector< std::string > & result, std::string_view chars, int maxsplit = -1, bool collapse = false );
+    inline std::vector< std::string > split_any( std::string_view str, std::string_view chars, int maxsplit = -1, bool collapse = false )
+    {
+        std::vector< std::string > result;
+        split_any( str, result, chars, maxsplit, collapse );
+        return result;
+    }
+    void split_any( std::string_view str, std::vector< std::string > & result, const CharSet & chars, int maxsplit = -1, bool collapse = false );
+    inline std::vector< std::string > split_any( std::string_view str, const CharSet & chars, int maxsplit = -1, bool collapse = false )
+    {
+        std::vector< std::string > result;
+        split_any( str, result, chars, maxsplit, collapse );
+        return result;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief split_any, starting at the end of the string. See split_any and rsplit.
+    ///
+    void rsplit_any( std::string_view str, std::vector< std::string > & result, std::string_view chars, int maxsplit = -1, bool collapse = false );
+    inline std::vector< std::string > rsplit_any( std::string_view str, std::string_view chars, int maxsplit = -1, bool collapse = false )
+    {
+        std::vector< std::string > result;
+        rsplit_any( str, result, chars, maxsplit, collapse );
+        return result;
+    }
+    void rsplit_any( std::string_view str, std::vector< std::string > & result, const CharSet & chars, int maxsplit = -1, bool collapse = false );
+    inline std::vector< std::string > rsplit_any( std::string_view str, const CharSet & chars, int maxsplit = -1, bool collapse = false )
+    {
+        std::vector< std::string > result;
+        rsplit_any( str, result, chars, maxsplit, collapse );
+        return result;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return a list of the lines in the string, breaking at line boundaries. Line breaks
     /// are not included in the resulting list unless keepends is given and true.
@@ -256,6 +412,11 @@ namespace pystring
         return result;
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Like splitlines, reusing the strings result already holds. See split_reuse.
+    ///
+    void splitlines_reuse(  std::string_view str, std::vector< std::string > & result, bool keepends = false );
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return True if string starts with the prefix, otherwise return False. With optional start,
     /// test string beginning at that position. With optional end, stop comparing string at that
@@ -269,6 +430,7 @@ namespace pystring
     /// stripped from the both ends of the string this method is called on.
     ///
     std::string strip( std::string_view str, std::string_view chars = "" );
+    std::string strip( std::string_view str, const CharSet & chars );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return a copy of the string with uppercase characters converted to lowercase and vice versa.
@@ -287,6 +449,7 @@ namespace pystring
     /// translation table, which must be a string of length 256.
     ///
     std::string translate( std::string_view str, std::string_view table, std::string_view deletechars = "");
+    std::string translate( std::string_view str, std::string_view table, const CharSet & deletechars );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Return a copy of the string converted to uppercase.
@@ -308,137 +471,1390 @@ namespace pystring
     /// @ }
     ///
 
-
-namespace os
-{
-namespace path
-{
-    // All of the function below have three versions.
-    // Example:
-    //   join(...)
-    //   join_nt(...)
-    //   join_posix(...)
-    //
-    // The regular function dispatches to the other versions - based on the OS
-    // at compile time - to match the result you'd get from the python
-    // interepreter on the same operating system
-    // 
-    // Should you want to 'lock off' to a particular version of the string
-    // manipulation across *all* operating systems, use the version with the
-    // _OS you are interested in.  I.e., you can use posix style path joining,
-    // even on Windows, with join_posix.
-    //
-    // The naming, (nt, posix) matches the cpython source implementation.
-    
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @defgroup functions pystring::os::path
+    /// @defgroup functions64 pystring 64-bit index variants
     /// @{
-    
+    ///
+    /// The functions above take and return int offsets, which limits them to strings shorter
+    /// than 2**31 bytes. The _64 variants below accept and return std::ptrdiff_t offsets and
+    /// share their implementation with the int versions, so they behave identically on small
+    /// strings and remain correct on larger buffers (e.g. memory-mapped files).
+
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Return the base name of pathname path. This is the second half of the pair returned
-    /// by split(path). Note that the result of this function is different from the Unix basename
-    /// program; where basename for '/foo/bar/' returns 'bar', the basename() function returns an
-    /// empty string ('').
-    
-    std::string basename(std::string_view path);
-    std::string basename_nt(std::string_view path);
-    std::string basename_posix(std::string_view path);
+    /// @brief 64-bit index version of count.
+    ///
+    std::ptrdiff_t count_64( std::string_view str, std::string_view substr, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Return the directory name of pathname path. This is the first half of the pair
-    /// returned by split(path).
-    
-    std::string dirname(std::string_view path);
-    std::string dirname_nt(std::string_view path);
-    std::string dirname_posix(std::string_view path);
+    /// @brief 64-bit index version of endswith.
+    ///
+    bool endswith_64( std::string_view str, std::string_view suffix, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Return True if path is an absolute pathname. On Unix, that means it begins with a
-    /// slash, on Windows that it begins with a (back)slash after chopping off a potential drive
-    /// letter.
+    /// @brief 64-bit index version of find.
+    ///
+    std::ptrdiff_t find_64( std::string_view str, std::string_view sub, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
-    bool isabs(std::string_view path);
-    bool isabs_nt(std::string_view path);
-    bool isabs_posix(std::string_view s);
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief 64-bit index version of index.
+    ///
+    std::ptrdiff_t index_64( std::string_view str, std::string_view sub, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Return a normalized absolutized version of the pathname path.
-    /// 
-    /// NOTE: This differs from the interface of the python equivalent in that it requires you
-    /// to pass in the current working directory as an argument.
-    
-    std::string abspath(std::string_view path, std::string_view cwd);
-    std::string abspath_nt(std::string_view path, std::string_view cwd);
-    std::string abspath_posix(std::string_view path, std::string_view cwd);
-    
+    /// @brief 64-bit index version of rfind.
+    ///
+    std::ptrdiff_t rfind_64( std::string_view str, std::string_view sub, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Join one or more path components intelligently. If any component is an absolute
-    /// path, all previous components (on Windows, including the previous drive letter, if there
-    /// was one) are thrown away, and joining continues. The return value is the concatenation of
-    /// path1, and optionally path2, etc., with exactly one directory separator (os.sep) inserted
-    /// between components, unless path2 is empty. Note that on Windows, since there is a current
-    /// directory for each drive, os.path.join("c:", "foo") represents a path relative to the
-    /// current directory on drive C: (c:foo), not c:\foo.
-    
-    /// This dispatches based on the compilation OS
-    std::string join(std::string_view path1, std::string_view path2);
-    std::string join_nt(std::string_view path1, std::string_view path2);
-    std::string join_posix(std::string_view path1, std::string_view path2);
-    
-    std::string join(const std::vector< std::string > & paths);
-    std::string join_nt(const std::vector< std::string > & paths);
-    std::string join_posix(const std::vector< std::string > & paths);
+    /// @brief 64-bit index version of rindex.
+    ///
+    std::ptrdiff_t rindex_64( std::string_view str, std::string_view sub, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Normalize a pathname. This collapses redundant separators and up-level references
-    /// so that A//B, A/B/, A/./B and A/foo/../B all become A/B. It does not normalize the case
-    /// (use normcase() for that). On Windows, it converts forward slashes to backward slashes.
-    /// It should be understood that this may change the meaning of the path if it contains
-    /// symbolic links!
+    /// @brief 64-bit index version of startswith.
+    ///
+    bool startswith_64( std::string_view str, std::string_view prefix, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
 
-    std::string normpath(std::string_view path);
-    std::string normpath_nt(std::string_view path);
-    std::string normpath_posix(std::string_view path);
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief 64-bit index version of slice.
+    ///
+    std::string slice_64( std::string_view str, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
+
+    ///
+    /// @ }
+    ///
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Split the pathname path into a pair, (head, tail) where tail is the last pathname
-    /// component and head is everything leading up to that. The tail part will never contain a
-    /// slash; if path ends in a slash, tail will be empty. If there is no slash in path, head
-    /// will be empty. If path is empty, both head and tail are empty. Trailing slashes are
-    /// stripped from head unless it is the root (one or more slashes only). In all cases,
-    /// join(head, tail) returns a path to the same location as path (but the strings may
-    /// differ).
+    /// @defgroup icase pystring case-insensitive variants
+    /// @{
+    ///
+    /// These match their namesakes above but ignore ASCII case, without making lowercased
+    /// copies of either argument. Bytes outside 'A'..'Z' / 'a'..'z' must match exactly; use
+    /// utf8::casefold first for full Unicode caseless matching.
 
-    void split(std::string & head, std::string & tail, std::string_view path);
-    void split_nt(std::string & head, std::string & tail, std::string_view path);
-    void split_posix(std::string & head, std::string & tail, std::string_view path);
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Compare a and b ignoring ASCII case. Return a negative value, zero or a positive
+    /// value if a sorts before, equal to or after b, like std::string::compare.
+    ///
+    int icompare( std::string_view a, std::string_view b );
 
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Split the pathname path into a pair (drive, tail) where drive is either a drive
-    /// specification or the empty string. On systems which do not use drive specifications,
-    /// drive will always be the empty string. In all cases, drive + tail will be the same as
-    /// path.
-    
-    void splitdrive(std::string & drivespec, std::string & pathspec, std::string_view path);
-    void splitdrive_nt(std::string & drivespec, std::string & pathspec, std::string_view p);
-    void splitdrive_posix(std::string & drivespec, std::string & pathspec, std::string_view path);
-    
+    /// @brief Case-insensitive version of count.
+    ///
+    int icount( std::string_view str, std::string_view substr, int start = 0, int end = MAX_32BIT_INT );
+
     //////////////////////////////////////////////////////////////////////////////////////////////
-    /// @brief Split the pathname path into a pair (root, ext) such that root + ext == path, and
-    /// ext is empty or begins with a period and contains at most one period. Leading periods on
-    /// the basename are ignored; splitext('.cshrc') returns ('.cshrc', '').
+    /// @brief Case-insensitive version of endswith.
+    ///
+    bool iendswith( std::string_view str, std::string_view suffix, int start = 0, int end = MAX_32BIT_INT );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Case-insensitive version of find.
+    ///
+    int ifind( std::string_view str, std::string_view sub, int start = 0, int end = MAX_32BIT_INT );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Case-insensitive version of rfind.
+    ///
+    int irfind( std::string_view str, std::string_view sub, int start = 0, int end = MAX_32BIT_INT );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Case-insensitive version of startswith.
+    ///
+    bool istartswith( std::string_view str, std::string_view prefix, int start = 0, int end = MAX_32BIT_INT );
 
-    void splitext(std::string & root, std::string & ext, std::string_view path);
-    void splitext_nt(std::string & root, std::string & ext, std::string_view path);
-    void splitext_posix(std::string & root, std::string & ext, std::string_view path);
-    
     ///
     /// @ }
     ///
-} // namespace path
-} // namespace os
 
-} // namespace pystring
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup fnmatch pystring fnmatch
+    /// @{
+    ///
+    /// Ports of python's fnmatch module: shell-style wildcards where '*' matches everything,
+    /// '?' matches any single character, '[seq]' matches any character in seq and '[!seq]'
+    /// any character not in seq. There is no escape character and '*' also matches path
+    /// separators.
+    ///
+    /// As in os::path, fnmatch and filter have _nt and _posix versions. The _nt versions
+    /// normalize case (ASCII only) and treat '/' as '\\' in both the name and the pattern,
+    /// the _posix versions are case-sensitive, and the plain versions dispatch on the
+    /// compilation OS.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A wildcard pattern compiled once for matching many names.
+    ///
+    /// The pattern is split at its '*' runs into fixed width segments. The first and last
+    /// segments are anchored to the ends of the name and the middle ones are matched
+    /// leftmost-first, locating each literal run with a substring search. Matching is
+    /// therefore linear in the length of the name, with no backtracking.
+    ///
+    class CompiledPattern
+    {
+    public:
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Compile pattern. With normcase_nt, matching ignores ASCII case and treats
+        /// '/' and '\\' as equal, like fnmatch_nt. Otherwise it is exact, like fnmatchcase.
+        ///
+        explicit CompiledPattern( std::string_view pattern, bool normcase_nt = false );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return true if name matches the whole pattern.
+        ///
+        bool match( std::string_view name ) const;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append the elements of names that match to result.
+        ///
+        void filter( std::vector< std::string > & result, const std::vector< std::string > & names ) const;
+
+    private:
+        enum class TokenKind : std::uint8_t { literal, any, set };
+
+        // One element of a segment. Each token consumes a fixed number of characters: length
+        // for a literal run (stored at offset in m_literals), one for any and set (whose
+        // bitmap starts at m_sets[4 * offset]).
+        struct Token
+        {
+            TokenKind kind;
+            std::uint32_t offset, length;
+        };
+
+        // A run of tokens between two '*'. search is the index of the first literal token, if
+        // any, and search_offset its character offset within the segment.
+        struct Segment
+        {
+            std::size_t first, count, width;
+            std::size_t search, search_offset;
+        };
+
+        bool match_segment( const Segment & segment, const char * name ) const;
+        std::size_t find_segment( const Segment & segment, std::string_view name, std::size_t pos ) const;
+
+        std::vector< Token > m_tokens;
+        std::vector< Segment > m_segments;
+        std::vector< std::uint64_t > m_sets;
+        std::string m_literals;
+        bool m_anchor_start, m_anchor_end, m_normcase_nt;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Test whether name matches pattern, applying os.path.normcase to both.
+    ///
+    bool fnmatch( std::string_view name, std::string_view pattern );
+    bool fnmatch_nt( std::string_view name, std::string_view pattern );
+    bool fnmatch_posix( std::string_view name, std::string_view pattern );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Test whether name matches pattern, without any case normalization.
+    ///
+    bool fnmatchcase( std::string_view name, std::string_view pattern );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Fill result with the elements of names that match pattern. The pattern is
+    /// compiled once for the whole list.
+    ///
+    void filter( std::vector< std::string > & result, const std::vector< std::string > & names, std::string_view pattern );
+    void filter_nt( std::vector< std::string > & result, const std::vector< std::string > & names, std::string_view pattern );
+    void filter_posix( std::vector< std::string > & result, const std::vector< std::string > & names, std::string_view pattern );
+    inline std::vector< std::string > filter( const std::vector< std::string > & names, std::string_view pattern )
+    {
+        std::vector< std::string > result;
+        filter( result, names, pattern );
+        return result;
+    }
+
+    ///
+    /// @ }
+    ///
+
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup format pystring format
+    /// @{
+    ///
+    /// A subset of python's str.format. Replacement fields are "{}" (automatic numbering),
+    /// "{0}" (positional) or "{name}" (keyword), optionally followed by a format spec of
+    /// the form [[fill]align][sign][0][width][.precision][type] where align is one of
+    /// '<', '>', '^', '=', sign one of '+', '-', ' ' and type 'd' (integers) or 's'
+    /// (strings). "{{" and "}}" produce literal braces. For example:
+    ///
+    ///     format("{shot}/{seq}.{frame:04d}.exr", {}, {{"shot", "sh010"}, {"seq", "comp"}, {"frame", 7}})
+    ///         == "sh010/comp.0007.exr"
+    ///
+    /// Conversions ("{0!r}"), attribute or index access and nested fields are not supported.
+    /// Rather than raising like python, format returns the template unchanged if it cannot be
+    /// parsed, and a field whose argument is missing or of the wrong type is copied verbatim.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A format argument: an integer or a string. Strings are held by reference and
+    /// must outlive the call they are passed to. Unsigned integers keep their full range;
+    /// character types are not integers here, so format( "{}", { 'a' } ) does not compile.
+    ///
+    class FormatArg
+    {
+        template< typename T >
+        static constexpr bool is_integer = std::is_integral< T >::value && !std::is_same< T, bool >::value &&
+            !std::is_same< T, char >::value && !std::is_same< T, wchar_t >::value &&
+            !std::is_same< T, char16_t >::value && !std::is_same< T, char32_t >::value;
+
+    public:
+        FormatArg( std::string_view value ) : m_string( value ), m_int( 0 ), m_is_int( false ), m_is_unsigned( false ) { }
+        FormatArg( const char * value ) : m_string( value ), m_int( 0 ), m_is_int( false ), m_is_unsigned( false ) { }
+        FormatArg( const std::string & value ) : m_string( value ), m_int( 0 ), m_is_int( false ), m_is_unsigned( false ) { }
+
+        template< typename T, typename std::enable_if< is_integer< T > && std::is_signed< T >::value, int >::type = 0 >
+        FormatArg( T value ) : m_int( (long long) value ), m_is_int( true ), m_is_unsigned( false ) { }
+
+        template< typename T, typename std::enable_if< is_integer< T > && std::is_unsigned< T >::value, int >::type = 0 >
+        FormatArg( T value ) : m_uint( (unsigned long long) value ), m_is_int( true ), m_is_unsigned( true ) { }
+
+        bool is_int() const { return m_is_int; }
+        bool is_unsigned() const { return m_is_unsigned; }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief The integer value; as_int is only meaningful when !is_unsigned(), as_unsigned
+        /// when is_unsigned().
+        ///
+        long long as_int() const { return m_is_unsigned ? (long long) m_uint : m_int; }
+        unsigned long long as_unsigned() const { return m_is_unsigned ? m_uint : (unsigned long long) m_int; }
+        std::string_view as_string() const { return m_string; }
+
+    private:
+        std::string_view m_string;
+        union
+        {
+            long long m_int;
+            unsigned long long m_uint;
+        };
+        bool m_is_int;
+        bool m_is_unsigned;
+    };
+
+    typedef std::map< std::string, FormatArg, std::less<> > FormatKwargs;
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A format template parsed once for rendering many times. Rendering computes the
+    /// exact output size first and writes into a buffer reserved to that size.
+    ///
+    class CompiledFormat
+    {
+    public:
+        explicit CompiledFormat( std::string_view fmt );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return false if the template could not be parsed. An invalid template renders
+        /// as itself.
+        ///
+        bool valid() const { return m_valid; }
+
+        std::string render( const std::vector< FormatArg > & args, const FormatKwargs & kwargs = FormatKwargs() ) const;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append the rendered template to out.
+        ///
+        void render_into( std::string & out, const std::vector< FormatArg > & args, const FormatKwargs & kwargs = FormatKwargs() ) const;
+
+    private:
+        // A replacement field. Literal text, keyword names and the raw field text (used when
+        // the argument is missing) are ranges of m_text.
+        struct Field
+        {
+            std::size_t index;                  // positional index, or npos for a keyword
+            std::size_t name_offset, name_length;
+            std::size_t raw_offset, raw_length;
+            int width, precision;               // precision < 0 when absent
+            char fill, align, sign, type;       // align/sign/type are 0 when absent
+        };
+
+        struct Piece
+        {
+            std::size_t literal_offset, literal_length;
+            bool has_field;
+            Field field;
+        };
+
+        const FormatArg * lookup( const Field & field, const std::vector< FormatArg > & args, const FormatKwargs & kwargs ) const;
+
+        std::vector< Piece > m_pieces;
+        std::string m_text;
+        bool m_valid;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return fmt with its replacement fields substituted from the positional args and
+    /// keyword kwargs.
+    ///
+    std::string format( std::string_view fmt, const std::vector< FormatArg > & args, const FormatKwargs & kwargs = FormatKwargs() );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return fmt with its replacement fields substituted from the mapping kwargs.
+    ///
+    std::string format_map( std::string_view fmt, const FormatKwargs & kwargs );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return the decimal digits of n padded to width with fill. With the default '0'
+    /// fill the sign comes first, as zfill( std::to_string( n ), width ) would produce; any
+    /// other fill pads in front of the sign as rjust does.
+    ///
+    std::string format_int( long long n, int width = 0, char fill = '0' );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Append format_int( n, width, fill ) to dst.
+    ///
+    void format_int_into( std::string & dst, long long n, int width = 0, char fill = '0' );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Fill result with format_int( n, width, fill ) for each n in [first, last),
+    /// reusing the strings result already holds.
+    ///
+    void format_int_range( std::vector< std::string > & result, long long first, long long last, int width = 0, char fill = '0' );
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup numbers pystring number parsing
+    /// @{
+    ///
+    /// Locale independent, non-throwing equivalents of python's int() and float(). They return
+    /// std::errc() on success, std::errc::invalid_argument if str is not a number and
+    /// std::errc::result_out_of_range if it does not fit. value is left untouched on failure.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse str as python's int( str, base ) does: surrounding whitespace, an optional
+    /// sign, underscores between digits and, for base 0, 2, 8 or 16, a 0b/0o/0x prefix. Base 0
+    /// takes the base from the prefix and defaults to 10.
+    ///
+    std::errc to_int( std::string_view str, long long & value, int base = 10 );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse str as python's float( str ) does, including "inf", "infinity" and "nan".
+    /// Like python, values too large or small for a double become infinity or zero.
+    ///
+    std::errc to_float( std::string_view str, double & value );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse each of fields into result, which must have room for fields.size()
+    /// values, stopping at the first field that fails. Return the number of fields parsed,
+    /// fields.size() if all of them were.
+    ///
+    std::size_t to_int( const std::vector< std::string > & fields, long long * result, int base = 10 );
+    std::size_t to_float( const std::vector< std::string > & fields, double * result );
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup views pystring split views
+    /// @{
+    ///
+    /// Variants of split, rsplit and partition whose fields are views into str, collected in a
+    /// small_vector with inline storage or a caller provided array, so that splitting a short
+    /// string does not allocate. The views are only valid as long as str's data is.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief The size independent part of small_vector< T, N >, which functions take by
+    /// reference so they do not depend on N. T must be trivially copyable.
+    ///
+    template< typename T >
+    class small_vector_base
+    {
+        static_assert( std::is_trivially_copyable< T >::value, "small_vector requires a trivially copyable type" );
+
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+        typedef T * iterator;
+        typedef const T * const_iterator;
+
+        small_vector_base( const small_vector_base & ) = delete;
+        small_vector_base & operator=( const small_vector_base & ) = delete;
+
+        iterator begin() { return m_data; }
+        iterator end() { return m_data + m_size; }
+        const_iterator begin() const { return m_data; }
+        const_iterator end() const { return m_data + m_size; }
+
+        T * data() { return m_data; }
+        const T * data() const { return m_data; }
+        size_type size() const { return m_size; }
+        size_type capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return true while the elements still live in the inline storage.
+        ///
+        bool is_inline() const { return m_data == m_inline; }
+
+        T & operator[]( size_type i ) { return m_data[i]; }
+        const T & operator[]( size_type i ) const { return m_data[i]; }
+        T & front() { return m_data[0]; }
+        const T & front() const { return m_data[0]; }
+        T & back() { return m_data[m_size - 1]; }
+        const T & back() const { return m_data[m_size - 1]; }
+
+        void clear() { m_size = 0; }
+        void pop_back() { --m_size; }
+
+        void push_back( const T & value )
+        {
+            if ( m_size == m_capacity )
+            {
+                T copy = value;     // value may live in the storage grow releases
+                grow( m_size + 1 );
+                m_data[m_size++] = copy;
+                return;
+            }
+            m_data[m_size++] = value;
+        }
+
+        void reserve( size_type n )
+        {
+            if ( n > m_capacity ) grow( n );
+        }
+
+        void resize( size_type n )
+        {
+            reserve( n );
+            for ( size_type i = m_size; i < n; ++i ) m_data[i] = T();
+            m_size = n;
+        }
+
+        void assign( const_iterator first, const_iterator last )
+        {
+            m_size = 0;
+            reserve( (size_type) ( last - first ) );
+            if ( first != last ) std::memcpy( (void *) m_data, (const void *) first, (size_type) ( last - first ) * sizeof( T ) );
+            m_size = (size_type) ( last - first );
+        }
+
+    protected:
+        small_vector_base( T * inline_data, size_type inline_capacity )
+            : m_data( inline_data ), m_size( 0 ), m_capacity( inline_capacity ), m_inline( inline_data ) { }
+
+        ~small_vector_base()
+        {
+            if ( !is_inline() ) ::operator delete( (void *) m_data );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Take other's elements, stealing its heap storage if it has any.
+        ///
+        void take( small_vector_base & other, size_type other_inline_capacity )
+        {
+            if ( other.is_inline() )
+            {
+                assign( other.begin(), other.end() );
+            }
+            else
+            {
+                if ( !is_inline() ) ::operator delete( (void *) m_data );
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+                other.m_data = other.m_inline;
+                other.m_capacity = other_inline_capacity;
+            }
+            other.m_size = 0;
+        }
+
+    private:
+        void grow( size_type n )
+        {
+            size_type capacity = m_capacity * 2 > n ? m_capacity * 2 : n;
+            T * data = static_cast< T * >( ::operator new( capacity * sizeof( T ) ) );
+            if ( m_size ) std::memcpy( (void *) data, (const void *) m_data, m_size * sizeof( T ) );
+            if ( !is_inline() ) ::operator delete( (void *) m_data );
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        T * m_data;
+        size_type m_size;
+        size_type m_capacity;
+        T * m_inline;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A vector that keeps up to N elements inline before falling back to the heap.
+    ///
+    template< typename T, std::size_t N >
+    class small_vector : public small_vector_base< T >
+    {
+    public:
+        small_vector() : small_vector_base< T >( m_storage, N ) { }
+
+        small_vector( std::initializer_list< T > values ) : small_vector_base< T >( m_storage, N )
+        {
+            this->assign( values.begin(), values.end() );
+        }
+
+        small_vector( const small_vector & other ) : small_vector_base< T >( m_storage, N )
+        {
+            this->assign( other.begin(), other.end() );
+        }
+
+        small_vector( small_vector && other ) : small_vector_base< T >( m_storage, N )
+        {
+            this->take( other, N );
+        }
+
+        small_vector & operator=( const small_vector & other )
+        {
+            if ( this != &other ) this->assign( other.begin(), other.end() );
+            return *this;
+        }
+
+        small_vector & operator=( small_vector && other )
+        {
+            if ( this != &other ) this->take( other, N );
+            return *this;
+        }
+
+    private:
+        T m_storage[N];
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief The outcome of splitting into a fixed size array: the number of fields written
+    /// and whether fields were dropped because the array was full.
+    ///
+    struct split_result
+    {
+        std::size_t count;
+        bool truncated;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief split into views. See split.
+    ///
+    void split_view( std::string_view str, small_vector_base< std::string_view > & result, std::string_view sep = "", int maxsplit = -1 );
+    inline small_vector< std::string_view, 8 > split_view( std::string_view str, std::string_view sep = "", int maxsplit = -1 )
+    {
+        small_vector< std::string_view, 8 > result;
+        split_view( str, result, sep, maxsplit );
+        return result;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief split into the first capacity elements of result. If str has more fields than
+    /// that, the first capacity fields are written and truncated is set.
+    ///
+    split_result split_view( std::string_view str, std::string_view * result, std::size_t capacity, std::string_view sep = "", int maxsplit = -1 );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief rsplit into views. See rsplit.
+    ///
+    void rsplit_view( std::string_view str, small_vector_base< std::string_view > & result, std::string_view sep = "", int maxsplit = -1 );
+    inline small_vector< std::string_view, 8 > rsplit_view( std::string_view str, std::string_view sep = "", int maxsplit = -1 )
+    {
+        small_vector< std::string_view, 8 > result;
+        rsplit_view( str, result, sep, maxsplit );
+        return result;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief The three parts partition_view and rpartition_view split a string into.
+    ///
+    struct partition_result
+    {
+        std::string_view head, sep, tail;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief partition into three views, usable in constant expressions and with structured
+    /// bindings:
+    ///
+    ///     auto [name, dot, ext] = pystring::partition_view( "shot.exr", "." );
+    ///
+    /// See partition.
+    ///
+    constexpr partition_result partition_view( std::string_view str, std::string_view sep )
+    {
+        std::size_t index = str.find( sep );
+        if ( index == std::string_view::npos ) return { str, std::string_view(), std::string_view() };
+        return { str.substr( 0, index ), str.substr( index, sep.size() ), str.substr( index + sep.size() ) };
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief rpartition into three views. See partition_view and rpartition.
+    ///
+    constexpr partition_result rpartition_view( std::string_view str, std::string_view sep )
+    {
+        std::size_t index = str.rfind( sep );
+        if ( index == std::string_view::npos ) return { std::string_view(), std::string_view(), str };
+        return { str.substr( 0, index ), str.substr( index, sep.size() ), str.substr( index + sep.size() ) };
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief partition and rpartition into three views. See partition and rpartition.
+    ///
+    void partition_view( std::string_view str, std::string_view sep, small_vector_base< std::string_view > & result );
+    void rpartition_view( std::string_view str, std::string_view sep, small_vector_base< std::string_view > & result );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief strip, lstrip and rstrip returning the remaining sub-range of str, so trimming the
+    /// fields of a split_view never allocates. See strip.
+    ///
+    std::string_view strip_view( std::string_view str, std::string_view chars = "" );
+    std::string_view lstrip_view( std::string_view str, std::string_view chars = "" );
+    std::string_view rstrip_view( std::string_view str, std::string_view chars = "" );
+    std::string_view strip_view( std::string_view str, const CharSet & chars );
+    std::string_view lstrip_view( std::string_view str, const CharSet & chars );
+    std::string_view rstrip_view( std::string_view str, const CharSet & chars );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief removeprefix and removesuffix returning a view into str. See removeprefix.
+    ///
+    std::string_view removeprefix_view( std::string_view str, std::string_view prefix );
+    std::string_view removesuffix_view( std::string_view str, std::string_view suffix );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief slice returning a view into str. See slice.
+    ///
+    std::string_view slice_view( std::string_view str, int start = 0, int end = MAX_32BIT_INT );
+    std::string_view slice_view_64( std::string_view str, std::ptrdiff_t start = 0, std::ptrdiff_t end = MAX_PTRDIFF_T );
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup shlex pystring shlex
+    /// @{
+    ///
+    /// Shell-like tokenizing and quoting matching python's shlex module in POSIX mode, e.g.
+    ///
+    ///     shlex_split( "render -o 'my shot.exr' --note \"it's \\\"done\\\"\"" )
+    ///         == { "render", "-o", "my shot.exr", "--note", "it's \"done\"" }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Split str into shell words as python's shlex.split( str ) does. Return false, and
+    /// an empty result, if str has an unterminated quote or ends in an escape, where python
+    /// raises ValueError.
+    ///
+    bool shlex_split( std::string_view str, std::vector< std::string > & result );
+    inline std::vector< std::string > shlex_split( std::string_view str )
+    {
+        std::vector< std::string > result;
+        shlex_split( str, result );
+        return result;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief shlex_split into views. Words without quotes or escapes are views into str; the
+    /// others are unescaped into buffer, which is reserved to str's size the first time it is
+    /// needed. The views stay valid while str and buffer are unchanged.
+    ///
+    bool shlex_split_view( std::string_view str, small_vector_base< std::string_view > & result, std::string & buffer );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a shell-escaped version of str, as python's shlex.quote does.
+    ///
+    std::string shlex_quote( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Concatenate the shell-escaped args, separated by spaces, as python's
+    /// shlex.join does.
+    ///
+    std::string shlex_join( const std::vector< std::string > & args );
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup intern pystring interning
+    /// @{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A thread-safe pool of unique strings. intern returns a view of the pool's single
+    /// copy of a string, so repeated tokens cost one copy in total and interned views compare
+    /// equal exactly when their data() pointers do. Views stay valid until the pool is
+    /// destroyed. The pool is split into shards, each an open-addressing table behind its own
+    /// mutex with the strings packed into arena blocks.
+    ///
+    class InternPool
+    {
+    public:
+        InternPool();
+        ~InternPool();
+
+        InternPool( const InternPool & ) = delete;
+        InternPool & operator=( const InternPool & ) = delete;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return the pooled copy of str, adding it if it is new.
+        ///
+        std::string_view intern( std::string_view str );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return the number of distinct strings in the pool.
+        ///
+        std::size_t size() const;
+
+    private:
+        struct Shard;
+        std::unique_ptr< Shard[] > m_shards;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief split, interning each field in pool. See split.
+    ///
+    void split_intern( std::string_view str, std::vector< std::string_view > & result, InternPool & pool, std::string_view sep = "", int maxsplit = -1 );
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup column pystring string columns
+    /// @{
+    ///
+    /// A column packs a sequence of strings into one byte buffer plus an array of offsets, as
+    /// Arrow does: string i is bytes()[offsets()[i], offsets()[i + 1]). Filling a column costs
+    /// two growing allocations rather than one per string, and scanning it reads memory in
+    /// order. StringColumn holds up to 4 GiB of string data, LargeStringColumn more.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A packed column of strings whose offsets are of unsigned type Offset. Elements
+    /// are read as views, which stay valid until the column is next modified.
+    ///
+    template< typename Offset >
+    class BasicStringColumn
+    {
+        static_assert( std::is_unsigned< Offset >::value, "BasicStringColumn requires an unsigned offset type" );
+
+    public:
+        typedef Offset offset_type;
+        typedef std::size_t size_type;
+        typedef std::string_view value_type;
+
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::string_view value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const std::string_view * pointer;
+            typedef std::string_view reference;
+
+            const_iterator() : m_column( nullptr ), m_index( 0 ) {}
+            const_iterator( const BasicStringColumn * column, size_type index ) : m_column( column ), m_index( index ) {}
+
+            std::string_view operator*() const { return ( *m_column )[m_index]; }
+            const_iterator & operator++() { ++m_index; return *this; }
+            const_iterator operator++( int ) { const_iterator old = *this; ++m_index; return old; }
+            bool operator==( const const_iterator & other ) const { return m_index == other.m_index; }
+            bool operator!=( const const_iterator & other ) const { return m_index != other.m_index; }
+
+        private:
+            const BasicStringColumn * m_column;
+            size_type m_index;
+        };
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief The most string data a column can hold.
+        ///
+        static constexpr std::size_t max_bytes()
+        {
+            return std::numeric_limits< Offset >::max() < std::numeric_limits< std::size_t >::max()
+                ? (std::size_t) std::numeric_limits< Offset >::max() : std::numeric_limits< std::size_t >::max();
+        }
+
+        const_iterator begin() const { return const_iterator( this, 0 ); }
+        const_iterator end() const { return const_iterator( this, size() ); }
+
+        size_type size() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+        bool empty() const { return size() == 0; }
+
+        std::string_view operator[]( size_type i ) const
+        {
+            return std::string_view( m_data.data() + m_offsets[i], (std::size_t) ( m_offsets[i + 1] - m_offsets[i] ) );
+        }
+        std::string_view front() const { return ( *this )[0]; }
+        std::string_view back() const { return ( *this )[size() - 1]; }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief The packed string data and the size() + 1 offsets into it.
+        ///
+        std::string_view bytes() const { return m_data; }
+        const Offset * offsets() const { return m_offsets.empty() ? &zero_offset : m_offsets.data(); }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Reserve room for count strings holding bytes bytes in total.
+        ///
+        void reserve( size_type count, std::size_t bytes )
+        {
+            m_offsets.reserve( count + 1 );
+            m_data.reserve( bytes );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Remove every string, keeping the allocated storage.
+        ///
+        void clear()
+        {
+            m_data.clear();
+            m_offsets.clear();
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append a copy of str. Return false, leaving the column unchanged, if the
+        /// column would then hold more than max_bytes().
+        ///
+        bool append( std::string_view str )
+        {
+            if ( str.size() > max_bytes() - m_data.size() ) return false;
+            if ( m_offsets.empty() ) m_offsets.push_back( 0 );
+            m_data.append( str.data(), str.size() );
+            m_offsets.push_back( (Offset) m_data.size() );
+            return true;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Grow the string being built at the end of the column by n bytes and return a
+        /// pointer to them, valid until the column is next modified. seal() adds the string.
+        ///
+        char * extend( std::size_t n )
+        {
+            std::size_t old_size = m_data.size();
+            m_data.resize( old_size + n );
+            return &m_data[0] + old_size;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append a copy of bytes to the string being built and return a pointer to the
+        /// copy, for editing in place. Unlike extend( n ), nothing is zero-filled first.
+        ///
+        char * extend( std::string_view bytes )
+        {
+            std::size_t old_size = m_data.size();
+            m_data.append( bytes.data(), bytes.size() );
+            return &m_data[0] + old_size;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Add the string built by extend() since the last string, which may be empty.
+        /// Return false, discarding its bytes, if the column would then hold more than
+        /// max_bytes().
+        ///
+        bool seal()
+        {
+            if ( m_data.size() > max_bytes() )
+            {
+                m_data.resize( m_offsets.empty() ? 0 : (std::size_t) m_offsets.back() );
+                return false;
+            }
+            if ( m_offsets.empty() ) m_offsets.push_back( 0 );
+            m_offsets.push_back( (Offset) m_data.size() );
+            return true;
+        }
+
+        void swap( BasicStringColumn & other )
+        {
+            m_data.swap( other.m_data );
+            m_offsets.swap( other.m_offsets );
+        }
+
+    private:
+        static constexpr Offset zero_offset = 0;
+
+        std::string m_data;
+        std::vector< Offset > m_offsets;        // empty, or size() + 1 entries starting at 0
+    };
+
+    typedef BasicStringColumn< std::uint32_t > StringColumn;
+    typedef BasicStringColumn< std::uint64_t > LargeStringColumn;
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief split into result, replacing its contents. The fields are counted first so the
+    /// column is filled with one allocation for the data and one for the offsets. Return false,
+    /// leaving result empty, if str is larger than result can hold. See split.
+    ///
+    bool split_to_column( std::string_view str, StringColumn & result, std::string_view sep = "", int maxsplit = -1 );
+    bool split_to_column( std::string_view str, LargeStringColumn & result, std::string_view sep = "", int maxsplit = -1 );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief splitlines into result, replacing its contents. See split_to_column and
+    /// splitlines.
+    ///
+    bool splitlines_to_column( std::string_view str, StringColumn & result, bool keepends = false );
+    bool splitlines_to_column( std::string_view str, LargeStringColumn & result, bool keepends = false );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return the strings of seq joined by str. See join.
+    ///
+    std::string join( std::string_view str, const StringColumn & seq );
+    std::string join( std::string_view str, const LargeStringColumn & seq );
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup builder pystring string builder
+    /// @{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Builds a long string from many pieces without regrowing it. Pieces are kept as a
+    /// list of chunks: copies live in arena blocks that never move, and append_view records
+    /// a chunk that refers to the caller's memory. str() and write() then copy each byte once,
+    /// into a string sized up front or straight to a file descriptor.
+    ///
+    class StringBuilder
+    {
+    public:
+        StringBuilder();
+        ~StringBuilder();
+
+        StringBuilder( const StringBuilder & ) = delete;
+        StringBuilder & operator=( const StringBuilder & ) = delete;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append a copy of str.
+        ///
+        void append( std::string_view str );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append str without copying it. Its data must stay valid and unchanged until the
+        /// builder is flattened or cleared.
+        ///
+        void append_view( std::string_view str );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append join( str, seq ).
+        ///
+        void append_join( std::string_view str, const std::vector< std::string > & seq );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append str padded to width with fill: align is '<' as ljust, '>' as rjust or
+        /// '^' as center.
+        ///
+        void append_padded( std::string_view str, int width, char align = '<', char fill = ' ' );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Append replace( str, oldstr, newstr, count ).
+        ///
+        void append_replace( std::string_view str, std::string_view oldstr, std::string_view newstr, int count = -1 );
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return the length of the string built so far.
+        ///
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return the string built so far, or append it to out.
+        ///
+        std::string str() const;
+        void str_into( std::string & out ) const;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Write the string built so far to the file descriptor fd, gathering the chunks
+        /// with writev where available. Return false if a write fails.
+        ///
+        bool write( int fd ) const;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Remove every chunk and release the arena.
+        ///
+        void clear();
+
+    private:
+        struct Chunk
+        {
+            const char * data;
+            std::size_t size;
+        };
+
+        char * reserve( std::size_t n );
+        void append_copy( const char * data, std::size_t n );
+        void append_fill( char fill, std::size_t n );
+
+        std::vector< Chunk > m_chunks;
+        std::vector< std::unique_ptr< char[] > > m_blocks;
+        char * m_block_pos;
+        std::size_t m_block_left;
+        std::size_t m_block_size;
+        std::size_t m_size;
+    };
+
+    ///
+    /// @ }
+    ///
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup isa pystring kernel dispatch
+    /// @{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Instruction sets the byte kernels (search, classify, case mapping, translate and
+    /// count) are built for. The best one the CPU supports is selected on first use. Setting
+    /// PYSTRING_FORCE_ISA to scalar, sse2 or avx2 in the environment caps the selection, so
+    /// every variant can be tested on one machine.
+    ///
+    enum class isa { scalar, sse2, avx2 };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return the instruction set of the kernels in use.
+    ///
+    isa selected_isa();
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if kernels for level are built in and the CPU supports them.
+    ///
+    bool isa_supported( isa level );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Switch every kernel to level. Returns false, changing nothing, if level is not
+    /// supported. Calls already running finish on the kernels they started with.
+    ///
+    bool force_isa( isa level );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return "scalar", "sse2" or "avx2".
+    ///
+    const char * isa_name( isa level );
+
+    ///
+    /// @ }
+    ///
+
+
+namespace os
+{
+namespace path
+{
+    // All of the function below have three versions.
+    // Example:
+    //   join(...)
+    //   join_nt(...)
+    //   join_posix(...)
+    //
+    // The regular function dispatches to the other versions - based on the OS
+    // at compile time - to match the result you'd get from the python
+    // interepreter on the same operating system
+    // 
+    // Should you want to 'lock off' to a particular version of the string
+    // manipulation across *all* operating systems, use the version with the
+    // _OS you are interested in.  I.e., you can use posix style path joining,
+    // even on Windows, with join_posix.
+    //
+    // The naming, (nt, posix) matches the cpython source implementation.
+    
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup functions pystring::os::path
+    /// @{
+    
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return the base name of pathname path. This is the second half of the pair returned
+    /// by split(path). Note that the result of this function is different from the Unix basename
+    /// program; where basename for '/foo/bar/' returns 'bar', the basename() function returns an
+    /// empty string ('').
+    
+    std::string basename(std::string_view path);
+    std::string basename_nt(std::string_view path);
+    std::string basename_posix(std::string_view path);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return the directory name of pathname path. This is the first half of the pair
+    /// returned by split(path).
+    
+    std::string dirname(std::string_view path);
+    std::string dirname_nt(std::string_view path);
+    std::string dirname_posix(std::string_view path);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return True if path is an absolute pathname. On Unix, that means it begins with a
+    /// slash, on Windows that it begins with a (back)slash after chopping off a potential drive
+    /// letter.
+
+    bool isabs(std::string_view path);
+    bool isabs_nt(std::string_view path);
+    bool isabs_posix(std::string_view s);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a normalized absolutized version of the pathname path.
+    /// 
+    /// NOTE: This differs from the interface of the python equivalent in that it requires you
+    /// to pass in the current working directory as an argument.
+    
+    std::string abspath(std::string_view path, std::string_view cwd);
+    std::string abspath_nt(std::string_view path, std::string_view cwd);
+    std::string abspath_posix(std::string_view path, std::string_view cwd);
+    
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Join one or more path components intelligently. If any component is an absolute
+    /// path, all previous components (on Windows, including the previous drive letter, if there
+    /// was one) are thrown away, and joining continues. The return value is the concatenation of
+    /// path1, and optionally path2, etc., with exactly one directory separator (os.sep) inserted
+    /// between components, unless path2 is empty. Note that on Windows, since there is a current
+    /// directory for each drive, os.path.join("c:", "foo") represents a path relative to the
+    /// current directory on drive C: (c:foo), not c:\foo.
+    
+    /// This dispatches based on the compilation OS
+    std::string join(std::string_view path1, std::string_view path2);
+    std::string join_nt(std::string_view path1, std::string_view path2);
+    std::string join_posix(std::string_view path1, std::string_view path2);
+    
+    std::string join(const std::vector< std::string > & paths);
+    std::string join_nt(const std::vector< std::string > & paths);
+    std::string join_posix(const std::vector< std::string > & paths);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Normalize a pathname. This collapses redundant separators and up-level references
+    /// so that A//B, A/B/, A/./B and A/foo/../B all become A/B. It does not normalize the case
+    /// (use normcase() for that). On Windows, it converts forward slashes to backward slashes.
+    /// It should be understood that this may change the meaning of the path if it contains
+    /// symbolic links!
+
+    std::string normpath(std::string_view path);
+    std::string normpath_nt(std::string_view path);
+    std::string normpath_posix(std::string_view path);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Split the pathname path into a pair, (head, tail) where tail is the last pathname
+    /// component and head is everything leading up to that. The tail part will never contain a
+    /// slash; if path ends in a slash, tail will be empty. If there is no slash in path, head
+    /// will be empty. If path is empty, both head and tail are empty. Trailing slashes are
+    /// stripped from head unless it is the root (one or more slashes only). In all cases,
+    /// join(head, tail) returns a path to the same location as path (but the strings may
+    /// differ).
+
+    void split(std::string & head, std::string & tail, std::string_view path);
+    void split_nt(std::string & head, std::string & tail, std::string_view path);
+    void split_posix(std::string & head, std::string & tail, std::string_view path);
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Split the pathname path into a pair (drive, tail) where drive is either a drive
+    /// specification or the empty string. On systems which do not use drive specifications,
+    /// drive will always be the empty string. In all cases, drive + tail will be the same as
+    /// path.
+    
+    void splitdrive(std::string & drivespec, std::string & pathspec, std::string_view path);
+    void splitdrive_nt(std::string & drivespec, std::string & pathspec, std::string_view p);
+    void splitdrive_posix(std::string & drivespec, std::string & pathspec, std::string_view path);
+    
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Split the pathname path into a pair (root, ext) such that root + ext == path, and
+    /// ext is empty or begins with a period and contains at most one period. Leading periods on
+    /// the basename are ignored; splitext('.cshrc') returns ('.cshrc', '').
+
+    void splitext(std::string & root, std::string & ext, std::string_view path);
+    void splitext_nt(std::string & root, std::string & ext, std::string_view path);
+    void splitext_posix(std::string & root, std::string & ext, std::string_view path);
+    
+    ///
+    /// @ }
+    ///
+} // namespace path
+} // namespace os
+
+namespace batch
+{
+    // Batch versions of common transformations. Each takes a sequence of strings and writes
+    // the results, in order, into a string column, so a batch costs a few growing allocations
+    // instead of one per string and the per-call checks are paid once. The result column is
+    // cleared first; if the output does not fit in it the functions return false and leave
+    // it empty.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup functions pystring::batch
+    /// @{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A read-only sequence of strings viewed either as an array of string_views or as
+    /// the strings of a column. It refers to its source, which must outlive it.
+    ///
+    class StringSpan
+    {
+    public:
+        StringSpan( const std::string_view * strs, std::size_t count )
+            : m_views( strs ), m_bytes( nullptr ), m_offsets32( nullptr ), m_offsets64( nullptr ), m_size( count ) {}
+
+        StringSpan( const std::vector< std::string_view > & strs )
+            : StringSpan( strs.data(), strs.size() ) {}
+
+        StringSpan( const StringColumn & column )
+            : m_views( nullptr ), m_bytes( column.bytes().data() ), m_offsets32( column.offsets() ), m_offsets64( nullptr ),
+              m_size( column.size() ) {}
+
+        StringSpan( const LargeStringColumn & column )
+            : m_views( nullptr ), m_bytes( column.bytes().data() ), m_offsets32( nullptr ), m_offsets64( column.offsets() ),
+              m_size( column.size() ) {}
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        std::string_view operator[]( std::size_t i ) const
+        {
+            if ( m_views ) return m_views[i];
+            if ( m_offsets32 ) return std::string_view( m_bytes + m_offsets32[i], m_offsets32[i + 1] - m_offsets32[i] );
+            return std::string_view( m_bytes + m_offsets64[i], (std::size_t) ( m_offsets64[i + 1] - m_offsets64[i] ) );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Return the total length of the strings.
+        ///
+        std::size_t total_bytes() const;
+
+    private:
+        const std::string_view * m_views;
+        const char * m_bytes;
+        const std::uint32_t * m_offsets32;
+        const std::uint64_t * m_offsets64;
+        std::size_t m_size;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief pystring::strip of each string. See strip.
+    ///
+    bool strip( const StringSpan & strs, StringColumn & result, std::string_view chars = "" );
+    bool strip( const StringSpan & strs, LargeStringColumn & result, std::string_view chars = "" );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief pystring::lower of each string. See lower.
+    ///
+    bool lower( const StringSpan & strs, StringColumn & result );
+    bool lower( const StringSpan & strs, LargeStringColumn & result );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief pystring::replace of each string. See replace.
+    ///
+    bool replace( const StringSpan & strs, StringColumn & result, std::string_view oldstr, std::string_view newstr, int count = -1 );
+    bool replace( const StringSpan & strs, LargeStringColumn & result, std::string_view oldstr, std::string_view newstr, int count = -1 );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief pystring::zfill of each string. See zfill.
+    ///
+    bool zfill( const StringSpan & strs, StringColumn & result, int width );
+    bool zfill( const StringSpan & strs, LargeStringColumn & result, int width );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief os::path::normpath of each path. See os::path::normpath.
+    ///
+    bool normpath( const StringSpan & paths, StringColumn & result );
+    bool normpath( const StringSpan & paths, LargeStringColumn & result );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief os::path::basename of each path. See os::path::basename.
+    ///
+    bool basename( const StringSpan & paths, StringColumn & result );
+    bool basename( const StringSpan & paths, LargeStringColumn & result );
+
+    ///
+    /// @ }
+    ///
+} // namespace batch
+
+namespace utf8
+{
+    // UTF-8 aware versions of the classification and case functions. Runs of ASCII bytes
+    // are detected in blocks and handed to the byte functions above, so pure ASCII input
+    // costs little more than calling those directly; only non-ASCII code points are decoded.
+    //
+    // Classification and simple (one to one) case mappings follow python's unicodedata for
+    // the Unicode version the tables in pystring_unicode_tables.h were generated from. As
+    // with the byte functions, the is* predicates require every character to have the
+    // property and return false for the empty string. They also return false for invalid
+    // UTF-8; the case functions copy invalid bytes through unchanged.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup functions pystring::utf8
+    /// @{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if str is well formed UTF-8 (no overlong forms, surrogates or code
+    /// points past U+10FFFF). The empty string is valid.
+    ///
+    bool isvalid( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all characters are letters (categories Lu, Ll, Lt, Lm, Lo) or
+    /// decimal digits (Nd), and there is at least one character.
+    ///
+    bool isalnum( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all characters are letters (categories Lu, Ll, Lt, Lm, Lo) and there
+    /// is at least one character.
+    ///
+    bool isalpha( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all characters are decimal digits (category Nd) and there is at
+    /// least one character.
+    ///
+    bool isdigit( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all cased characters are lowercase and there is at least one cased
+    /// character, so digits and punctuation are allowed alongside ( islower( "\xC3\xA9!" ) ).
+    ///
+    bool islower( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all characters are whitespace (as python's str.isspace, e.g. U+00A0
+    /// or U+3000) and there is at least one character.
+    ///
+    bool isspace( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if the string is titlecased: uppercase and titlecase characters only
+    /// follow uncased ones and lowercase characters only cased ones, and there is at least one
+    /// cased character.
+    ///
+    bool istitle( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return true if all cased characters are uppercase and there is at least one cased
+    /// character.
+    ///
+    bool isupper( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a copy of the string with the simple lowercase mapping applied.
+    ///
+    std::string lower( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a copy of the string with the simple uppercase mapping applied.
+    ///
+    std::string upper( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a copy of the string with uppercase characters converted to lowercase and
+    /// vice versa.
+    ///
+    std::string swapcase( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a titlecased version of the string: words start with titlecase characters,
+    /// all remaining cased characters are lowercase.
+    ///
+    std::string title( std::string_view str );
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Return a casefolded copy of the string, suitable for caseless matching. Unlike
+    /// lower this uses the full folding, so e.g. "\u00DF" (sharp s) becomes "ss".
+    ///
+    std::string casefold( std::string_view str );
+
+    ///
+    /// @ }
+    ///
+} // namespace utf8
+
+} // namespace pystring
+
+#if defined(PYSTRING_HEADER_ONLY)
+#include "pystring.cpp"
+#endif
 
 #endif
@@ -0,0 +1,243 @@
+// Copyright Contributors to the Pystring project.
+// SPDX-License-Identifier: BSD-3-Clause
+// https://github.com/imageworks/pystring/blob/master/LICENSE
+
+
+#ifndef INCLUDED_PYSTRING_CO_H
+#define INCLUDED_PYSTRING_CO_H
+
+#include "pystring.h"
+
+// The generators need C++20 coroutines. In earlier language modes this header declares nothing,
+// so it can be included unconditionally; the library itself is built as C++17 either way.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define PYSTRING_HAVE_COROUTINES 1
+#endif
+#endif
+
+#if defined(PYSTRING_HAVE_COROUTINES)
+
+#include <coroutine>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace pystring
+{
+namespace co
+{
+    // Lazy, single pass sources of string_views for chaining parsing stages without building
+    // intermediate vectors. Each view is only valid until the generator is resumed, so copy
+    // what has to outlive the current step.
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @defgroup functions pystring::co
+    /// @{
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief A move-only generator of T, iterated once with a range for loop.
+    ///
+    template< typename T >
+    class generator
+    {
+    public:
+        struct promise_type
+        {
+            const T * value = nullptr;
+
+            generator get_return_object() { return generator( std::coroutine_handle< promise_type >::from_promise( *this ) ); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value( const T & v ) noexcept { value = std::addressof( v ); return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        class iterator
+        {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T * pointer;
+            typedef const T & reference;
+
+            iterator() = default;
+            explicit iterator( std::coroutine_handle< promise_type > handle ) : m_handle( handle ) {}
+
+            const T & operator*() const { return *m_handle.promise().value; }
+            const T * operator->() const { return m_handle.promise().value; }
+            iterator & operator++() { m_handle.resume(); return *this; }
+            void operator++( int ) { m_handle.resume(); }
+            bool operator==( std::default_sentinel_t ) const { return !m_handle || m_handle.done(); }
+
+        private:
+            std::coroutine_handle< promise_type > m_handle;
+        };
+
+        generator( generator && other ) noexcept : m_handle( std::exchange( other.m_handle, nullptr ) ) {}
+        generator & operator=( generator && other ) noexcept
+        {
+            if ( this != &other )
+            {
+                if ( m_handle ) m_handle.destroy();
+                m_handle = std::exchange( other.m_handle, nullptr );
+            }
+            return *this;
+        }
+        ~generator() { if ( m_handle ) m_handle.destroy(); }
+
+        generator( const generator & ) = delete;
+        generator & operator=( const generator & ) = delete;
+
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// @brief Run the generator to its first value. Call once.
+        ///
+        iterator begin()
+        {
+            if ( m_handle ) m_handle.resume();
+            return iterator( m_handle );
+        }
+        std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    private:
+        explicit generator( std::coroutine_handle< promise_type > handle ) : m_handle( handle ) {}
+
+        std::coroutine_handle< promise_type > m_handle;
+    };
+
+    const std::size_t default_buffer_size = 64 * 1024;
+
+    namespace detail
+    {
+        //////////////////////////////////////////////////////////////////////////////////////////
+        /// Yield the lines of the bytes produced by read( dst, capacity ), which returns the
+        /// number of bytes stored and 0 at the end of the input. Lines are split as splitlines
+        /// splits them and are views into one buffer, refilled once its complete lines are
+        /// used up. The buffer only grows to hold a single line longer than it.
+        ///
+        template< typename Read >
+        generator< std::string_view > read_lines( Read read, bool keepends, std::size_t buffer_size )
+        {
+            if ( buffer_size < 2 ) buffer_size = 2;
+            std::unique_ptr< char[] > buffer( new char[buffer_size] );
+            std::size_t begin = 0, end = 0, i = 0;      // unused bytes are [begin, end), scanned up to i
+            bool eof = false;
+
+            while ( true )
+            {
+                while ( true )
+                {
+                    while ( i < end && buffer[i] != '\n' && buffer[i] != '\r' ) ++i;
+                    if ( i == end ) break;
+
+                    // A '\r' ending the buffer may be the first half of "\r\n".
+                    std::size_t next = i + 1;
+                    if ( buffer[i] == '\r' )
+                    {
+                        if ( next == end && !eof ) break;
+                        if ( next < end && buffer[next] == '\n' ) ++next;
+                    }
+
+                    co_yield std::string_view( buffer.get() + begin, ( keepends ? next : i ) - begin );
+                    begin = i = next;
+                }
+
+                if ( eof )
+                {
+                    if ( begin < end ) co_yield std::string_view( buffer.get() + begin, end - begin );
+                    co_return;
+                }
+
+                // Move the partial line to the front and refill behind it.
+                std::size_t partial = end - begin;
+                if ( partial == buffer_size )
+                {
+                    std::unique_ptr< char[] > larger( new char[buffer_size * 2] );
+                    std::memcpy( larger.get(), buffer.get(), partial );
+                    buffer.swap( larger );
+                    buffer_size *= 2;
+                }
+                else if ( begin && partial )
+                {
+                    std::memmove( buffer.get(), buffer.get() + begin, partial );
+                }
+                i -= begin;
+                begin = 0;
+                end = partial;
+
+                std::size_t n = read( buffer.get() + end, buffer_size - end );
+                if ( n == 0 ) eof = true;
+                end += n;
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Generate the lines of in as splitlines( contents, keepends ) would, reading
+    /// buffer_size bytes at a time. A read error ends the input.
+    ///
+    inline generator< std::string_view > lines( std::istream & in, bool keepends = false, std::size_t buffer_size = default_buffer_size )
+    {
+        return detail::read_lines( [&in]( char * dst, std::size_t n ) -> std::size_t
+        {
+            in.read( dst, (std::streamsize) n );
+            return (std::size_t) in.gcount();
+        }, keepends, buffer_size );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Generate the lines read from the file descriptor fd. See lines( std::istream & ).
+    ///
+    inline generator< std::string_view > lines( int fd, bool keepends = false, std::size_t buffer_size = default_buffer_size )
+    {
+        return detail::read_lines( [fd]( char * dst, std::size_t n ) -> std::size_t
+        {
+#if defined(_WIN32)
+            int got = ::_read( fd, dst, (unsigned int) ( n < 0x40000000 ? n : 0x40000000 ) );
+            return got > 0 ? (std::size_t) got : 0;
+#else
+            while ( true )
+            {
+                ssize_t got = ::read( fd, dst, n );
+                if ( got >= 0 ) return (std::size_t) got;
+                if ( errno != EINTR ) return 0;
+            }
+#endif
+        }, keepends, buffer_size );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Generate the fields of each string from source, split as split( str, sep,
+    /// maxsplit ) would. The fields of a line are collected in a reused small_vector.
+    ///
+    inline generator< std::string_view > fields( generator< std::string_view > source, std::string sep = "", int maxsplit = -1 )
+    {
+        small_vector< std::string_view, 16 > parts;
+        for ( std::string_view str : source )
+        {
+            split_view( str, parts, sep, maxsplit );
+            for ( std::string_view field : parts ) co_yield field;
+        }
+    }
+
+    ///
+    /// @ }
+    ///
+
+} // namespace co
+} // namespace pystring
+
+#endif // PYSTRING_HAVE_COROUTINES
+
+#endif
@@ -6,6 +6,17 @@
 #include "pystring.h"
 #include "unittest.h"
 
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
 PYSTRING_TEST_APP(PyStringUnitTests)
 
 PYSTRING_ADD_TEST(pystring, endswith)
@@ -30,6 +41,8 @@ PYSTRING_ADD_TEST(pystring, endswith)
     PYSTRING_CHECK_EQUAL(pystring::endswith("abcdef", "cdef", 3), false);
     PYSTRING_CHECK_EQUAL(pystring::endswith("abcdef", "cdef", 2, 3), false);
     PYSTRING_CHECK_EQUAL(pystring::endswith("abcdef", "cdef", -10), true);
+    
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::endswith("a.mesh", ".mesh"), 0);
 }
 
 PYSTRING_ADD_TEST(pystring, find)
@@ -63,6 +76,8 @@ PYSTRING_ADD_TEST(pystring, find)
     PYSTRING_CHECK_EQUAL(pystring::find("abcabcabc", "bc", 4, 5), -1);
     PYSTRING_CHECK_EQUAL(pystring::find("abcabcabc", "bc", 4, -1), 4);
     PYSTRING_CHECK_EQUAL(pystring::find("abcabcabc", "bc", 4, 6), 4);
+    
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::find("abcabcabc", "bc", 4, -1), 0);
 }
 
 PYSTRING_ADD_TEST(pystring, rfind)
@@ -95,6 +110,33 @@ PYSTRING_ADD_TEST(pystring, rfind)
     PYSTRING_CHECK_EQUAL(pystring::rfind("abcabcabc", "bc", 4, 20), 7);
     
     PYSTRING_CHECK_EQUAL(pystring::rfind("abcabcabc", "abc", 6, 8), -1);
+    PYSTRING_CHECK_EQUAL(pystring::rfind("abcabcabc", "bc", 0, 8), 4);
+    
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::rfind("abcabcabc", "bc", 4, 20), 0);
+
+    // Long haystacks exercise the block scan from the end; every needle position and slice
+    // bound must agree with std::string_view::rfind.
+    for (std::size_t len = 0; len <= 70; ++len)
+    {
+        std::string hay(len, 'x');
+        for (std::size_t pos = 0; pos < len; ++pos)
+        {
+            for (std::string needle : { "y", "yz", "yxz", "yxxxxxxxxxxxxxxxxz" })
+            {
+                if (pos + needle.size() > len) continue;
+                std::string s = hay;
+                s.replace(pos, needle.size(), needle);
+                if (pos >= needle.size()) s.replace(0, needle.size(), needle);
+                int expected = (int) std::string_view(s).rfind(needle);
+                int limited = (int) std::string_view(s).substr(0, len - 1).rfind(needle);
+                if (pystring::rfind(s, needle) != expected || pystring::rfind(s, needle, 0, -1) != limited ||
+                    pystring::rfind(s, needle, (int) pos + 1) != (expected > (int) pos ? expected : -1))
+                {
+                    PYSTRING_CHECK_EQUAL(s + " " + needle, "");
+                }
+            }
+        }
+    }
 }
 
 PYSTRING_ADD_TEST(pystring, removeprefix)
@@ -284,10 +326,102 @@ PYSTRING_ADD_TEST(pystring, split)
             PYSTRING_CHECK_EQUAL(result[2], "world");
         }
     }
+    
+    {
+        // Once the result has grown, refilling it with short tokens must
+        // not touch the heap.
+        result.clear();
+        pystring::split("/root/world", result, "/");
+        PYSTRING_CHECK_MAX_ALLOCS(pystring::split("/root/world", result, "/"), 0);
+        PYSTRING_CHECK_MAX_ALLOCS(pystring::split(" root  world ", result), 0);
+    }
+}
+
+PYSTRING_ADD_TEST(pystring, count)
+{
+    PYSTRING_CHECK_EQUAL(pystring::count("abcabcabc", "bc"), 3);
+    PYSTRING_CHECK_EQUAL(pystring::count("abcabcabc", "bc", 2), 2);
+    PYSTRING_CHECK_EQUAL(pystring::count("abcabcabc", "bc", 2, -2), 1);
+    PYSTRING_CHECK_EQUAL(pystring::count("aaaa", "aa"), 2);
+    PYSTRING_CHECK_EQUAL(pystring::count("abc", "d"), 0);
+    PYSTRING_CHECK_EQUAL(pystring::count("abc", ""), 4);
+    PYSTRING_CHECK_EQUAL(pystring::count("abc", "", 1), 3);
+    PYSTRING_CHECK_EQUAL(pystring::count("abc", "", 3), 1);
+    PYSTRING_CHECK_EQUAL(pystring::count("abc", "", 4), 0);
+    PYSTRING_CHECK_EQUAL(pystring::count("abc", "", 2, 1), 0);
+    PYSTRING_CHECK_EQUAL(pystring::count_64("", ""), 1);
+    
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::count("abcabcabc", "bc"), 0);
+}
+
+PYSTRING_ADD_TEST(pystring, index_64)
+{
+    PYSTRING_CHECK_EQUAL(pystring::find_64("abcabcabc", "bc", 4, -1), 4);
+    PYSTRING_CHECK_EQUAL(pystring::find_64("abcabcabc", "bc", 0, 2), -1);
+    PYSTRING_CHECK_EQUAL(pystring::find_64("abc", "", 3), 3);
+    PYSTRING_CHECK_EQUAL(pystring::find_64("abc", "", 4), -1);
+    PYSTRING_CHECK_EQUAL(pystring::find_64("abc", "", 2, 1), -1);
+    PYSTRING_CHECK_EQUAL(pystring::rfind_64("abcabcabc", "bc", 4, 20), 7);
+    PYSTRING_CHECK_EQUAL(pystring::count_64("abcabcabc", "bc", 2, -2), 1);
+    PYSTRING_CHECK_EQUAL(pystring::slice_64("abcdef", 2, -1), "cde");
+    PYSTRING_CHECK_EQUAL(pystring::startswith_64("abcdef", "bc", 1), true);
+    PYSTRING_CHECK_EQUAL(pystring::endswith_64("abcdef", "cdef", 2, 3), false);
+
+#if !defined(_WIN32) && defined(MAP_ANONYMOUS) && defined(MAP_NORESERVE)
+    if (sizeof(void *) < 8) return;
+
+    // A lazily committed anonymous mapping a little over 2 GiB. Untouched
+    // pages read back as zeros, so only the pages we write cost memory.
+    const std::ptrdiff_t base = (std::ptrdiff_t) 1 << 31;
+    const std::size_t size = (std::size_t) base + 8192;
+    void * mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) return;
+
+    char * data = static_cast< char * >( mem );
+    std::memcpy(data + base + 100, "needle", 6);
+    std::memcpy(data + base + 200, "needle", 6);
+    std::string_view big(data, size);
+
+    PYSTRING_CHECK_EQUAL(pystring::find_64(big, "needle", base), base + 100);
+    PYSTRING_CHECK_EQUAL(pystring::find_64(big, "needle", base + 101), base + 200);
+    PYSTRING_CHECK_EQUAL(pystring::find_64(big, "needle", -7900), -1);
+    PYSTRING_CHECK_EQUAL(pystring::rfind_64(big, "needle"), base + 200);
+    PYSTRING_CHECK_EQUAL(pystring::rfind_64(big, "needle", 0, base + 205), base + 100);
+    PYSTRING_CHECK_EQUAL(pystring::count_64(big, "needle", base), 2);
+
+    // Bounded searches only look at [start, end), not the rest of the mapping.
+    PYSTRING_CHECK_EQUAL(pystring::find_64(big, "needle", 0, 64), -1);
+    PYSTRING_CHECK_EQUAL(pystring::count_64(big, "needle", 0, 64), 0);
+    PYSTRING_CHECK_EQUAL(pystring::find_64(big, "needle", base, base + 105), -1);
+    PYSTRING_CHECK_EQUAL(pystring::find_64(big, "needle", base, base + 106), base + 100);
+    PYSTRING_CHECK_EQUAL(pystring::count_64(big, "needle", base, base + 205), 1);
+    PYSTRING_CHECK_EQUAL(pystring::slice_64(big, base + 100, base + 106), "needle");
+    PYSTRING_CHECK_EQUAL(pystring::slice_64(big, -8092, -8086), "needle");
+    PYSTRING_CHECK_EQUAL(pystring::startswith_64(big, "needle", base + 200), true);
+    PYSTRING_CHECK_EQUAL(pystring::endswith_64(big, "needle", 0, base + 106), true);
+
+    munmap(mem, size);
+#endif
 }
 
 PYSTRING_ADD_TEST(pystring, rsplit)
 {
+    {
+        // Separators on both sides of the 16 and 32 byte block edges.
+        std::string long_str;
+        for (int i = 0; i < 12; ++i) long_str += "field" + std::to_string(i) + "::";
+        long_str += "end";
+        for (int maxsplit = 0; maxsplit < 15; ++maxsplit)
+        {
+            std::vector<std::string> parts = pystring::rsplit(long_str, "::", maxsplit);
+            std::vector<std::string> all = pystring::split(long_str, "::");
+            std::size_t kept = all.size() - parts.size() + 1;
+            PYSTRING_CHECK_EQUAL(parts.size(), std::min<std::size_t>(all.size(), (std::size_t) maxsplit + 1));
+            PYSTRING_CHECK_EQUAL(parts.front(), pystring::join("::", std::vector<std::string>(all.begin(), all.begin() + kept)));
+            PYSTRING_CHECK_EQUAL(parts.back(), maxsplit ? "end" : long_str);
+        }
+    }
     std::vector< std::string > result;
     {
         result.clear();
@@ -495,6 +629,8 @@ PYSTRING_ADD_TEST(pystring, startswith)
     PYSTRING_CHECK_EQUAL(pystring::startswith("abcdef", "abc"), true);
     PYSTRING_CHECK_EQUAL(pystring::startswith("abcdef", "abc", 1), false);
     PYSTRING_CHECK_EQUAL(pystring::startswith("abcdef", "bc", 1), true);
+    
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::startswith("abcdef", "bc", 1), 0);
 }
 
 PYSTRING_ADD_TEST(pystring, strip)
@@ -506,6 +642,9 @@ PYSTRING_ADD_TEST(pystring, strip)
     PYSTRING_CHECK_EQUAL(pystring::strip("\n a "), "a");
     PYSTRING_CHECK_EQUAL(pystring::strip("\r\n a \r\n"), "a");
     PYSTRING_CHECK_EQUAL(pystring::strip("\r\n a \r\n\t"), "a");
+    
+    // Short results fit in the small string buffer.
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::strip("  a  "), 0);
 }
 
 PYSTRING_ADD_TEST(pystring, translate)
@@ -545,6 +684,16 @@ PYSTRING_ADD_TEST(pystring_os_path, splitdrive)
     splitdrive_posix(drivespec, pathspec, "/Users/test"); PYSTRING_CHECK_EQUAL(drivespec, ""); PYSTRING_CHECK_EQUAL(pathspec, "/Users/test");
     splitdrive_nt(drivespec, pathspec, "C:\\Users\\test"); PYSTRING_CHECK_EQUAL(drivespec, "C:" ); PYSTRING_CHECK_EQUAL(pathspec, "\\Users\\test" );
     splitdrive_nt(drivespec, pathspec, "\\Users\\test"); PYSTRING_CHECK_EQUAL(drivespec, "" ); PYSTRING_CHECK_EQUAL(pathspec, "\\Users\\test" );
+
+    // The input may alias either output.
+    pathspec = "D:\\shows\\seq";
+    splitdrive_nt(drivespec, pathspec, pathspec); PYSTRING_CHECK_EQUAL(drivespec, "D:" ); PYSTRING_CHECK_EQUAL(pathspec, "\\shows\\seq" );
+    drivespec = "E:\\shows";
+    splitdrive_nt(drivespec, pathspec, drivespec); PYSTRING_CHECK_EQUAL(drivespec, "E:" ); PYSTRING_CHECK_EQUAL(pathspec, "\\shows" );
+    drivespec = "\\shows";
+    splitdrive_nt(drivespec, pathspec, drivespec); PYSTRING_CHECK_EQUAL(drivespec, "" ); PYSTRING_CHECK_EQUAL(pathspec, "\\shows" );
+    pathspec = "\\shows";
+    splitdrive_nt(drivespec, pathspec, pathspec); PYSTRING_CHECK_EQUAL(drivespec, "" ); PYSTRING_CHECK_EQUAL(pathspec, "\\shows" );
 }
 
 PYSTRING_ADD_TEST(pystring_os_path, isabs)
@@ -651,6 +800,16 @@ PYSTRING_ADD_TEST(pystring_os_path, split)
     split_nt(head, tail, "c:\\a\\b");  PYSTRING_CHECK_EQUAL(head, "c:\\a" );  PYSTRING_CHECK_EQUAL(tail, "b" );
     split_nt(head, tail, "c:\\a\\b\\");  PYSTRING_CHECK_EQUAL(head, "c:\\a\\b" );  PYSTRING_CHECK_EQUAL(tail, "" );
     split_nt(head, tail, "D:\\dir\\\\");  PYSTRING_CHECK_EQUAL(head, "D:\\dir" );  PYSTRING_CHECK_EQUAL(tail, "" );
+    split_nt(head, tail, "c:\\a/b\\c/d");  PYSTRING_CHECK_EQUAL(head, "c:\\a/b\\c" );  PYSTRING_CHECK_EQUAL(tail, "d" );
+    split_nt(head, tail, "c:/a\\b/c\\d");  PYSTRING_CHECK_EQUAL(head, "c:/a\\b/c" );  PYSTRING_CHECK_EQUAL(tail, "d" );
+
+    // Long paths, where the last separator is found by the block scan from the end.
+    std::string deep = "/show/seq/shot/" + std::string(40, 'x') + "/render." + std::string(20, '0') + ".exr";
+    split_posix(head, tail, deep);
+    PYSTRING_CHECK_EQUAL(head, "/show/seq/shot/" + std::string(40, 'x'));
+    PYSTRING_CHECK_EQUAL(tail, "render." + std::string(20, '0') + ".exr");
+    split_nt(head, tail, pystring::replace(deep, "/", "\\"));
+    PYSTRING_CHECK_EQUAL(tail, "render." + std::string(20, '0') + ".exr");
 
 }
 
@@ -668,4 +827,1182 @@ PYSTRING_ADD_TEST(pystring_os_path, splitext)
     splitext_nt(root, ext, "a_b.c"); PYSTRING_CHECK_EQUAL(root, "a_b"); PYSTRING_CHECK_EQUAL(ext, ".c");
     splitext_nt(root, ext, "c:\\a.b.c"); PYSTRING_CHECK_EQUAL(root, "c:\\a.b"); PYSTRING_CHECK_EQUAL(ext, ".c");
     splitext_nt(root, ext, "c:\\a_b.c"); PYSTRING_CHECK_EQUAL(root, "c:\\a_b"); PYSTRING_CHECK_EQUAL(ext, ".c");
+    splitext_posix(root, ext, "..cshrc"); PYSTRING_CHECK_EQUAL(root, "..cshrc"); PYSTRING_CHECK_EQUAL(ext, "");
+    splitext_posix(root, ext, "/a/..b.c"); PYSTRING_CHECK_EQUAL(root, "/a/..b"); PYSTRING_CHECK_EQUAL(ext, ".c");
+    splitext_posix(root, ext, "a.b/..c"); PYSTRING_CHECK_EQUAL(root, "a.b/..c"); PYSTRING_CHECK_EQUAL(ext, "");
+    splitext_posix(root, ext, "/a.b/" + std::string(40, 'c')); PYSTRING_CHECK_EQUAL(ext, "");
+    splitext_posix(root, ext, "/a/" + std::string(40, 'c') + ".tar.gz"); PYSTRING_CHECK_EQUAL(root, "/a/" + std::string(40, 'c') + ".tar"); PYSTRING_CHECK_EQUAL(ext, ".gz");
+}
+
+PYSTRING_ADD_TEST(pystring_utf8, isvalid)
+{
+    using namespace pystring::utf8;
+
+    PYSTRING_CHECK_EQUAL(isvalid(""), true);
+    PYSTRING_CHECK_EQUAL(isvalid("plain ascii"), true);
+    PYSTRING_CHECK_EQUAL(isvalid("d\xC3\xA9j\xC3\xA0 vu \xE2\xB1\xA5 \xF0\x9F\x98\x80"), true);
+    PYSTRING_CHECK_EQUAL(isvalid("\xC3"), false);                 // truncated
+    PYSTRING_CHECK_EQUAL(isvalid("\xC0\xAF"), false);             // overlong '/'
+    PYSTRING_CHECK_EQUAL(isvalid("\xED\xA0\x80"), false);         // surrogate
+    PYSTRING_CHECK_EQUAL(isvalid("\xF4\x90\x80\x80"), false);     // > U+10FFFF
+    PYSTRING_CHECK_EQUAL(isvalid("abcdefghijklmnopqrstuvwxyz\x80"), false);
+}
+
+PYSTRING_ADD_TEST(pystring_utf8, classify)
+{
+    using namespace pystring::utf8;
+
+    PYSTRING_CHECK_EQUAL(isalpha(""), false);
+    PYSTRING_CHECK_EQUAL(isalpha("abc"), true);
+    PYSTRING_CHECK_EQUAL(isalpha("d\xC3\xA9j\xC3\xA0"), true);
+    PYSTRING_CHECK_EQUAL(isalpha("d\xC3\xA9j\xC3\xA0 vu"), false);
+    PYSTRING_CHECK_EQUAL(isalpha("\xE6\x97\xA5\xE6\x9C\xAC"), true);        // CJK
+    PYSTRING_CHECK_EQUAL(isalpha("\xC3"), false);
+
+    PYSTRING_CHECK_EQUAL(isdigit("0123"), true);
+    PYSTRING_CHECK_EQUAL(isdigit("\xD9\xA1\xD9\xA2\xD9\xA3"), true);        // Arabic-Indic 123
+    PYSTRING_CHECK_EQUAL(isdigit("\xC2\xB2"), false);                       // superscript two is No
+    PYSTRING_CHECK_EQUAL(isalnum("abc\xD9\xA1\xC3\xA9"), true);
+
+    PYSTRING_CHECK_EQUAL(isspace(" \t\xC2\xA0\xE3\x80\x80"), true);        // NBSP, ideographic space
+    PYSTRING_CHECK_EQUAL(isspace(" \xC2\xA0x"), false);
+
+    PYSTRING_CHECK_EQUAL(islower("d\xC3\xA9j\xC3\xA0"), true);
+    PYSTRING_CHECK_EQUAL(islower("D\xC3\xA9j\xC3\xA0"), false);
+    PYSTRING_CHECK_EQUAL(isupper("\xC3\x80\xC3\x89\xCE\xA3"), true);
+    PYSTRING_CHECK_EQUAL(isupper("\xC3\x80\xC3\xA9"), false);
+    // Only cased characters count: digits and punctuation may appear on either side.
+    PYSTRING_CHECK_EQUAL(islower("\xC3\xA9" "1"), true);
+    PYSTRING_CHECK_EQUAL(islower("1\xC3\xA9"), true);
+    PYSTRING_CHECK_EQUAL(islower("\xC3\xA9!"), true);
+    PYSTRING_CHECK_EQUAL(islower("12 \xC3\xA9t\xC3\xA9 3"), true);
+    PYSTRING_CHECK_EQUAL(islower("1\xC3\x89"), false);
+    PYSTRING_CHECK_EQUAL(islower("\xC7\x85"), false);
+    PYSTRING_CHECK_EQUAL(islower("123"), false);
+    PYSTRING_CHECK_EQUAL(isupper("\xC3\x89" "1"), true);
+    PYSTRING_CHECK_EQUAL(isupper("- \xC3\x89T\xC3\x89 2"), true);
+    PYSTRING_CHECK_EQUAL(isupper("\xC3\x89t"), false);
+    PYSTRING_CHECK_EQUAL(isupper("!?"), false);
+    PYSTRING_CHECK_EQUAL(isupper("\xC3\x89\xFF"), false);
+
+    PYSTRING_CHECK_EQUAL(istitle("\xC3\x80\xC3\xA9\xC3\xAE D\xC3\xA9j\xC3\xA0"), true);
+    PYSTRING_CHECK_EQUAL(istitle("\xC7\x85" "emal"), true);                  // titlecase digraph
+    PYSTRING_CHECK_EQUAL(istitle("\xC3\x80\xC3\x89"), false);
+}
+
+PYSTRING_ADD_TEST(pystring_utf8, case_mapping)
+{
+    using namespace pystring::utf8;
+
+    const char * mixed = "\xC3\x80\xC3\x89\xC3\x8E\xC3\x95\xC3\x9C d\xC3\xA9j\xC3\xA0 vu";
+    PYSTRING_CHECK_EQUAL(lower(mixed), "\xC3\xA0\xC3\xA9\xC3\xAE\xC3\xB5\xC3\xBC d\xC3\xA9j\xC3\xA0 vu");
+    PYSTRING_CHECK_EQUAL(upper(mixed), "\xC3\x80\xC3\x89\xC3\x8E\xC3\x95\xC3\x9C D\xC3\x89J\xC3\x80 VU");
+    PYSTRING_CHECK_EQUAL(title(mixed), "\xC3\x80\xC3\xA9\xC3\xAE\xC3\xB5\xC3\xBC D\xC3\xA9j\xC3\xA0 Vu");
+    PYSTRING_CHECK_EQUAL(swapcase(mixed), "\xC3\xA0\xC3\xA9\xC3\xAE\xC3\xB5\xC3\xBC D\xC3\x89J\xC3\x80 VU");
+
+    // The encoded length may change: U+023A -> U+2C65.
+    PYSTRING_CHECK_EQUAL(lower("\xC8\xBA"), "\xE2\xB1\xA5");
+    PYSTRING_CHECK_EQUAL(upper("\xE2\xB1\xA5"), "\xC8\xBA");
+
+    // Titlecase digraphs.
+    PYSTRING_CHECK_EQUAL(lower("\xC7\x85" "emal"), "\xC7\x86" "emal");
+    PYSTRING_CHECK_EQUAL(upper("\xC7\x85" "emal"), "\xC7\x84" "EMAL");
+    PYSTRING_CHECK_EQUAL(title("\xC7\x86" "EMAL"), "\xC7\x85" "emal");
+    PYSTRING_CHECK_EQUAL(swapcase("\xC7\x85" "emal"), "\xC7\x85" "EMAL");
+
+    // Long ASCII runs go through the block path and must match the byte functions.
+    std::string ascii = "The Quick Brown Fox Jumps Over The Lazy Dog 0123456789";
+    PYSTRING_CHECK_EQUAL(lower(ascii), pystring::lower(ascii));
+    PYSTRING_CHECK_EQUAL(upper(ascii), pystring::upper(ascii));
+    PYSTRING_CHECK_EQUAL(title(pystring::lower(ascii)), pystring::title(pystring::lower(ascii)));
+
+    // Invalid bytes are copied through.
+    PYSTRING_CHECK_EQUAL(lower("A\xFF" "B"), "a\xFF" "b");
+}
+
+PYSTRING_ADD_TEST(pystring_utf8, casefold)
+{
+    using namespace pystring::utf8;
+
+    PYSTRING_CHECK_EQUAL(casefold("Stra\xC3\x9F" "e"), "strasse");
+    PYSTRING_CHECK_EQUAL(casefold("\xCE\xA3\xCE\x91\xCE\xA3"), "\xCF\x83\xCE\xB1\xCF\x83");
+    PYSTRING_CHECK_EQUAL(casefold("\xCF\x82"), "\xCF\x83");                  // final sigma
+    PYSTRING_CHECK_EQUAL(casefold("\xEF\xAC\x81" "ne"), "fine");             // fi ligature
+    PYSTRING_CHECK_EQUAL(casefold("\xE1\x8E\xA0"), "\xE1\x8E\xA0");          // Cherokee folds to upper
+    PYSTRING_CHECK_EQUAL(casefold("\xEA\xAD\xB0"), "\xE1\x8E\xA0");
+    PYSTRING_CHECK_EQUAL(casefold("MiXeD"), "mixed");
+}
+
+PYSTRING_ADD_TEST(pystring, icase)
+{
+    PYSTRING_CHECK_EQUAL(pystring::ifind("", ""), 0);
+    PYSTRING_CHECK_EQUAL(pystring::ifind("abc", "", 4), -1);
+    PYSTRING_CHECK_EQUAL(pystring::ifind("Hello.EXR", ".exr"), 5);
+    PYSTRING_CHECK_EQUAL(pystring::ifind("Hello.EXR", ".exr", 6), -1);
+    PYSTRING_CHECK_EQUAL(pystring::ifind("abcABCabc", "BC", 2), 4);
+    PYSTRING_CHECK_EQUAL(pystring::ifind("abcABCabc", "BC", 4, 5), -1);
+    PYSTRING_CHECK_EQUAL(pystring::ifind("[\\]^_`", "@"), -1);       // punctuation around the letters is not folded
+    PYSTRING_CHECK_EQUAL(pystring::ifind("\xC3\x80", "\xC3\xA0"), -1);
+
+    PYSTRING_CHECK_EQUAL(pystring::irfind("abcABCabc", "BC"), 7);
+    PYSTRING_CHECK_EQUAL(pystring::irfind("abcABCabc", "BC", 0, 8), 4);
+    PYSTRING_CHECK_EQUAL(pystring::irfind("abcdef", ""), 6);
+    PYSTRING_CHECK_EQUAL(pystring::irfind("abcdef", "XYZ"), -1);
+
+    PYSTRING_CHECK_EQUAL(pystring::icount("abcABCabc", "BC"), 3);
+    PYSTRING_CHECK_EQUAL(pystring::icount("aAaA", "aa"), 2);
+    PYSTRING_CHECK_EQUAL(pystring::icount("abc", ""), 4);
+    PYSTRING_CHECK_EQUAL(pystring::icount("abc", "", 2, 1), 0);
+
+    PYSTRING_CHECK_EQUAL(pystring::istartswith("Shot010.EXR", "shot"), true);
+    PYSTRING_CHECK_EQUAL(pystring::istartswith("Shot010.EXR", "SHOT", 1), false);
+    PYSTRING_CHECK_EQUAL(pystring::iendswith("Shot010.EXR", ".exr"), true);
+    PYSTRING_CHECK_EQUAL(pystring::iendswith("Shot010.EXR", ".exr", 0, -1), false);
+
+    PYSTRING_CHECK_EQUAL(pystring::icompare("", ""), 0);
+    PYSTRING_CHECK_EQUAL(pystring::icompare("ABC", "abc"), 0);
+    PYSTRING_CHECK_LT(pystring::icompare("abc", "ABD"), 0);
+    PYSTRING_CHECK_GT(pystring::icompare("abcd", "ABC"), 0);
+    PYSTRING_CHECK_LT(pystring::icompare("ab", "abc"), 0);
+
+    // Long inputs exercise the block kernels; compare against lower() + find.
+    std::string hay = "Assets/Characters/Hero/Textures/Hero_Diffuse.TX;assets/characters/HERO/textures/hero_diffuse.tx";
+    std::string lowered = pystring::lower(hay);
+    const char * needles[] = { "hero_diffuse.tx", "TEXTURES/", "a", "x;A", "characters/hero/textures/hero", "zzz" };
+    for (const char * needle : needles)
+    {
+        std::string lneedle = pystring::lower(needle);
+        PYSTRING_CHECK_EQUAL(pystring::ifind(hay, needle), pystring::find(lowered, lneedle));
+        PYSTRING_CHECK_EQUAL(pystring::ifind(hay, needle, 20), pystring::find(lowered, lneedle, 20));
+        PYSTRING_CHECK_EQUAL(pystring::irfind(hay, needle), pystring::rfind(lowered, lneedle));
+        PYSTRING_CHECK_EQUAL(pystring::irfind(hay, needle, 0, -20), pystring::rfind(lowered, lneedle, 0, -20));
+        PYSTRING_CHECK_EQUAL(pystring::icount(hay, needle), pystring::count(lowered, lneedle));
+    }
+    PYSTRING_CHECK_EQUAL(pystring::icompare(hay, pystring::upper(hay)), 0);
+    PYSTRING_CHECK_LT(pystring::icompare(hay, hay + "!"), 0);
+
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::ifind(hay, "hero_diffuse.tx"), 0);
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::icompare(hay, lowered), 0);
+}
+
+PYSTRING_ADD_TEST(pystring, fnmatch)
+{
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("", ""), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("a", ""), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("", "*"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("a.txt", "*.txt"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("A.TXT", "*.txt"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("abc", "a?c"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("ac", "a?c"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("abc", "[!a]bc"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("xbc", "[!a]bc"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("[", "["), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("!", "[!]"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("]", "[]a]"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("-", "[a-]"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("x", "[z-a]"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("x", "[!z-a]"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("q", "[a-z]"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("aaab", "*a*b"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("ab", "*a*b*"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("a/b", "a*b"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("ab", "a*ab"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("shot010_v002.0101.exr", "shot*_v???.[0-9][0-9][0-9][0-9].exr"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase("shot010_v002.010x.exr", "shot*_v???.[0-9][0-9][0-9][0-9].exr"), false);
+
+    // Pathological for a backtracking matcher, linear here.
+    std::string name(2000, 'a');
+    PYSTRING_CHECK_EQUAL(pystring::fnmatchcase(name, "*a*a*a*a*a*a*a*a*a*a*a*b"), false);
+
+    PYSTRING_CHECK_EQUAL(pystring::fnmatch_posix("A.TXT", "*.txt"), false);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatch_nt("A.TXT", "*.txt"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatch_nt("C:/Assets/Hero.TX", "c:\\assets\\*.tx"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatch_nt("C:\\Assets\\Hero.TX", "c:/*/h[a-z]ro.tx"), true);
+    PYSTRING_CHECK_EQUAL(pystring::fnmatch_nt("Q", "[a-z]"), true);
+
+    pystring::CompiledPattern pattern("*.[ch]pp");
+    PYSTRING_CHECK_EQUAL(pattern.match("pystring.cpp"), true);
+    PYSTRING_CHECK_EQUAL(pattern.match("pystring.hpp"), true);
+    PYSTRING_CHECK_EQUAL(pattern.match("pystring.h"), false);
+    PYSTRING_CHECK_MAX_ALLOCS(pattern.match("pystring.cpp"), 0);
+
+    std::vector< std::string > names = { "a.py", "B.PY", "c.txt", "d.py" };
+    std::vector< std::string > result;
+    pystring::filter_posix(result, names, "*.py");
+    PYSTRING_CHECK_EQUAL(pystring::join(",", result), "a.py,d.py");
+    pystring::filter_nt(result, names, "*.py");
+    PYSTRING_CHECK_EQUAL(pystring::join(",", result), "a.py,B.PY,d.py");
+}
+
+PYSTRING_ADD_TEST(pystring, format)
+{
+    PYSTRING_CHECK_EQUAL(pystring::format("", {}), "");
+    PYSTRING_CHECK_EQUAL(pystring::format("plain", {}), "plain");
+    PYSTRING_CHECK_EQUAL(pystring::format("{} {}", {"a", 1}), "a 1");
+    PYSTRING_CHECK_EQUAL(pystring::format("{1}{0}{1}", {"a", "b"}), "bab");
+    PYSTRING_CHECK_EQUAL(pystring::format("{{{}}}", {7}), "{7}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:5}|{:5}", {"ab", 42}), "ab   |   42");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:04d}", {7}), "0007");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:05d}", {-42}), "-0042");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:+d} {: d} {:-d}", {3, 3, 3}), "+3  3 3");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:*^7}", {"abc"}), "**abc**");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:*^6}", {"abc"}), "*abc**");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:x=+6}", {12}), "+xxx12");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:<05}", {3}), "30000");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:05}", {"ab"}), "ab000");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:.2s}", {"abcdef"}), "ab");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:>6.3}", {"abcdef"}), "   abc");
+    PYSTRING_CHECK_EQUAL(pystring::format("{}", {-9223372036854775807LL - 1}), "-9223372036854775808");
+    PYSTRING_CHECK_EQUAL(pystring::format("{}", {18446744073709551615ULL}), "18446744073709551615");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:+}", {9223372036854775808ULL}), "+9223372036854775808");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:>4}", {(unsigned char) 200}), " 200");
+    PYSTRING_CHECK_EQUAL(pystring::format("{}", {(signed char) -5}), "-5");
+    static_assert(!std::is_convertible<char, pystring::FormatArg>::value, "char is not an integer argument");
+
+    // Missing or mistyped arguments are copied verbatim, malformed templates returned unchanged.
+    PYSTRING_CHECK_EQUAL(pystring::format("{} {} {}", {1}), "1 {} {}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:d}{:s}", {"a", 1}), "{:d}{:s}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:+}{:=5}", {"a", "b"}), "{:+}{:=5}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:.2}", {12}), "{:.2}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{name}", {}), "{name}");
+    PYSTRING_CHECK_EQUAL(pystring::format("a{", {1}), "a{");
+    PYSTRING_CHECK_EQUAL(pystring::format("a}b", {1}), "a}b");
+    PYSTRING_CHECK_EQUAL(pystring::format("{}{0}", {1}), "{}{0}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{0!r}", {1}), "{0!r}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{0.real}", {1}), "{0.real}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:{}}", {1, 2}), "{:{}}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:5x}", {1}), "{:5x}");
+    PYSTRING_CHECK_EQUAL(pystring::format("{:99999999999}", {1}), "{:99999999999}");
+
+    pystring::FormatKwargs kwargs = {{"shot", "sh010"}, {"seq", "comp"}, {"frame", 7}};
+    PYSTRING_CHECK_EQUAL(pystring::format_map("{shot}/{seq}.{frame:04d}.exr", kwargs), "sh010/comp.0007.exr");
+    PYSTRING_CHECK_EQUAL(pystring::format("{0}_{shot}", {"v2"}, kwargs), "v2_sh010");
+
+    pystring::CompiledFormat compiled("{seq}.{frame:04d}.exr");
+    PYSTRING_CHECK_EQUAL(compiled.valid(), true);
+    PYSTRING_CHECK_EQUAL(pystring::CompiledFormat("{").valid(), false);
+    PYSTRING_CHECK_EQUAL(compiled.render({}, kwargs), "comp.0007.exr");
+
+    std::string out = "frames: ";
+    for (int frame = 1; frame <= 3; ++frame)
+    {
+        kwargs.at("frame") = frame;
+        compiled.render_into(out, {}, kwargs);
+        out += ' ';
+    }
+    PYSTRING_CHECK_EQUAL(out, "frames: comp.0001.exr comp.0002.exr comp.0003.exr ");
+
+    out.clear();
+    out.reserve(64);
+    std::vector<pystring::FormatArg> args;
+    PYSTRING_CHECK_MAX_ALLOCS(compiled.render_into(out, args, kwargs), 0);
+    PYSTRING_CHECK_MAX_ALLOCS(compiled.render(args, kwargs), 1);
+}
+
+PYSTRING_ADD_TEST(pystring, to_int)
+{
+    long long value = 0;
+    PYSTRING_CHECK_EQUAL(pystring::to_int("42", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 42);
+    PYSTRING_CHECK_EQUAL(pystring::to_int(" \t-17\n", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, -17);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("+1_000_000", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 1000000);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("1234567890123456789", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 1234567890123456789LL);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("9223372036854775807", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 9223372036854775807LL);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("-9223372036854775808", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, -9223372036854775807LL - 1);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("00000000000000000000012", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 12);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("0x_ff", value, 0) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 255);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("0o17", value, 0) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 15);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("-0B101", value, 2) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, -5);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("ff", value, 16) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 255);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("zz", value, 36) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 1295);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("000", value, 0) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 0);
+
+    value = 7;
+    PYSTRING_CHECK_EQUAL(pystring::to_int("9223372036854775808", value) == std::errc::result_out_of_range, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("99999999999999999999", value) == std::errc::result_out_of_range, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int(" - 1", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("_1", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("1_", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("1__0", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("12a", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("0x10", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("0x", value, 16) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("012", value, 0) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_int("1", value, 37) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(value, 7);
+
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::to_int(" 1_234_567_890 ", value), 0);
+
+    std::vector<std::string> fields = pystring::split("1,22,333,4444", ",");
+    long long values[4] = {};
+    PYSTRING_CHECK_EQUAL(pystring::to_int(fields, values), 4);
+    PYSTRING_CHECK_EQUAL(values[3], 4444);
+    fields[2] = "x";
+    PYSTRING_CHECK_EQUAL(pystring::to_int(fields, values), 2);
+}
+
+PYSTRING_ADD_TEST(pystring, to_float)
+{
+    double value = 0;
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1.5", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 1.5);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("  -2.5e3 ", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, -2500.0);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("+.5", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 0.5);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("5.", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 5.0);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1_000.000_5", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 1000.0005);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1E-2", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 0.01);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("-Infinity", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(std::isinf(value) && value < 0, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("nAn", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(std::isnan(value), true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1e400", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(std::isinf(value) && value > 0, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("-0.0001e-400", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 0.0);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("0.1000000000000000055511151231257827", value) == std::errc(), true);
+    PYSTRING_CHECK_EQUAL(value, 0.1);
+
+    // The result does not depend on the C locale's decimal point.
+    const char * comma_locales[] = { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German_Germany.1252" };
+    for (const char * name : comma_locales)
+    {
+        if (!std::setlocale(LC_NUMERIC, name)) continue;
+        PYSTRING_CHECK_EQUAL(pystring::to_float("2.25", value) == std::errc(), true);
+        PYSTRING_CHECK_EQUAL(value, 2.25);
+        PYSTRING_CHECK_EQUAL(pystring::to_float("2,25", value) == std::errc::invalid_argument, true);
+        std::setlocale(LC_NUMERIC, "C");
+        break;
+    }
+
+    value = 7;
+    PYSTRING_CHECK_EQUAL(pystring::to_float("", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float(".", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1e", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("+-1", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1_.5", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1e_5", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("0x1p3", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("nan(1)", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(pystring::to_float("1.5x", value) == std::errc::invalid_argument, true);
+    PYSTRING_CHECK_EQUAL(value, 7.0);
+
+    std::vector<std::string> fields = pystring::split("0.5 1.5 2.5");
+    double values[3] = {};
+    PYSTRING_CHECK_EQUAL(pystring::to_float(fields, values), 3);
+    PYSTRING_CHECK_EQUAL(values[2], 2.5);
+}
+
+PYSTRING_ADD_TEST(pystring, format_int)
+{
+    PYSTRING_CHECK_EQUAL(pystring::format_int(0), "0");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(7, 4), "0007");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(-7, 4), "-007");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(-7, 4), pystring::zfill("-7", 4));
+    PYSTRING_CHECK_EQUAL(pystring::format_int(-7, 4, ' '), "  -7");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(12345, 4), "12345");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(1001, -3), "1001");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(9223372036854775807LL), "9223372036854775807");
+    PYSTRING_CHECK_EQUAL(pystring::format_int(-9223372036854775807LL - 1), "-9223372036854775808");
+    for (long long n = -1000; n <= 100000; n += 7)
+    {
+        if (pystring::format_int(n, 6) != pystring::zfill(std::to_string(n), 6))
+        {
+            PYSTRING_CHECK_EQUAL(pystring::format_int(n, 6), pystring::zfill(std::to_string(n), 6));
+            break;
+        }
+    }
+
+    std::string name = "shot.";
+    name.reserve(32);
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::format_int_into(name, 42, 4), 0);
+    PYSTRING_CHECK_EQUAL(name, "shot.0042");
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::format_int(1001, 4), 0);
+
+    std::vector<std::string> frames;
+    pystring::format_int_range(frames, 98, 102, 3);
+    PYSTRING_CHECK_EQUAL(pystring::join(",", frames), "098,099,100,101");
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::format_int_range(frames, 1, 5, 4), 0);
+    PYSTRING_CHECK_EQUAL(pystring::join(",", frames), "0001,0002,0003,0004");
+    pystring::format_int_range(frames, 5, 5);
+    PYSTRING_CHECK_EQUAL(frames.size(), 0);
+}
+
+PYSTRING_ADD_TEST(pystring, split_view)
+{
+    const char * samples[] = { "", "  ", "a", " a b  c ", "a,b,,c,", ",", "a--b--c", "a b\tc\nd" };
+    const char * seps[] = { "", ",", "--", " " };
+    for (const char * sample : samples)
+    {
+        for (const char * sep : seps)
+        {
+            for (int maxsplit = -1; maxsplit < 4; ++maxsplit)
+            {
+                std::vector<std::string> expected = pystring::split(sample, sep, maxsplit);
+                pystring::small_vector<std::string_view, 8> fields = pystring::split_view(sample, sep, maxsplit);
+                std::vector<std::string> actual(fields.begin(), fields.end());
+                PYSTRING_CHECK_EQUAL(pystring::join("|", actual), pystring::join("|", expected));
+                PYSTRING_CHECK_EQUAL(actual.size(), expected.size());
+
+                expected = pystring::rsplit(sample, sep, maxsplit);
+                fields = pystring::rsplit_view(sample, sep, maxsplit);
+                actual.assign(fields.begin(), fields.end());
+                PYSTRING_CHECK_EQUAL(pystring::join("|", actual), pystring::join("|", expected));
+                PYSTRING_CHECK_EQUAL(actual.size(), expected.size());
+            }
+        }
+    }
+
+    pystring::small_vector<std::string_view, 4> small;
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::split_view("a.b.c.d", small, "."), 0);
+    PYSTRING_CHECK_EQUAL(small.size(), 4);
+    PYSTRING_CHECK_EQUAL(small.is_inline(), true);
+    pystring::split_view("a.b.c.d.e.f", small, ".");
+    PYSTRING_CHECK_EQUAL(small.size(), 6);
+    PYSTRING_CHECK_EQUAL(small.is_inline(), false);
+    PYSTRING_CHECK_EQUAL(small[5], "f");
+
+    pystring::small_vector<std::string_view, 4> moved(std::move(small));
+    PYSTRING_CHECK_EQUAL(moved.size(), 6);
+    PYSTRING_CHECK_EQUAL(moved[0], "a");
+    PYSTRING_CHECK_EQUAL(small.size(), 0);
+    PYSTRING_CHECK_EQUAL(small.is_inline(), true);
+    small = moved;
+    PYSTRING_CHECK_EQUAL(small.size(), 6);
+    PYSTRING_CHECK_EQUAL(small.back(), "f");
+
+    std::string_view out[3];
+    pystring::split_result written = pystring::split_view("a b c", out, 3);
+    PYSTRING_CHECK_EQUAL(written.count, 3);
+    PYSTRING_CHECK_EQUAL(written.truncated, false);
+    written = pystring::split_view("a,b,c,d", out, 3, ",");
+    PYSTRING_CHECK_EQUAL(written.count, 3);
+    PYSTRING_CHECK_EQUAL(written.truncated, true);
+    PYSTRING_CHECK_EQUAL(out[2], "c");
+    written = pystring::split_view("a,b,c,d", out, 3, ",", 2);
+    PYSTRING_CHECK_EQUAL(written.truncated, false);
+    PYSTRING_CHECK_EQUAL(out[2], "c,d");
+    PYSTRING_CHECK_EQUAL(pystring::split_view("x", out, 0).truncated, true);
+
+    pystring::small_vector<std::string_view, 3> parts;
+    pystring::partition_view("a.b.c", ".", parts);
+    PYSTRING_CHECK_EQUAL(pystring::join("|", std::vector<std::string>(parts.begin(), parts.end())), "a|.|b.c");
+    pystring::rpartition_view("a.b.c", ".", parts);
+    PYSTRING_CHECK_EQUAL(pystring::join("|", std::vector<std::string>(parts.begin(), parts.end())), "a.b|.|c");
+    pystring::partition_view("abc", ".", parts);
+    PYSTRING_CHECK_EQUAL(parts[0], "abc");
+    PYSTRING_CHECK_EQUAL(parts[2], "");
+    pystring::rpartition_view("abc", ".", parts);
+    PYSTRING_CHECK_EQUAL(parts[0], "");
+    PYSTRING_CHECK_EQUAL(parts[2], "abc");
+}
+
+PYSTRING_ADD_TEST(pystring, split_reuse)
+{
+    const char * samples[] = { "", "a", " a b  c ", "a,b,,c,", "a--b--c", "one\ntwo\r\nthree\r\n\nfour" };
+    const char * seps[] = { "", ",", "--" };
+    std::vector<std::string> result = { "stale", "entries", "here", "x", "y", "z", "w", "v" };
+    for (const char * sample : samples)
+    {
+        for (const char * sep : seps)
+        {
+            for (int maxsplit = -1; maxsplit < 3; ++maxsplit)
+            {
+                pystring::split_reuse(sample, result, sep, maxsplit);
+                PYSTRING_CHECK_EQUAL(result == pystring::split(sample, sep, maxsplit), true);
+                pystring::rsplit_reuse(sample, result, sep, maxsplit);
+                PYSTRING_CHECK_EQUAL(result == pystring::rsplit(sample, sep, maxsplit), true);
+            }
+        }
+        pystring::splitlines_reuse(sample, result);
+        PYSTRING_CHECK_EQUAL(result == pystring::splitlines(sample), true);
+        pystring::splitlines_reuse(sample, result, true);
+        PYSTRING_CHECK_EQUAL(result == pystring::splitlines(sample, true), true);
+    }
+
+    std::string line = "a_long_field_name_beyond_sso,another_long_field_name_beyond_sso";
+    pystring::split_reuse(line, result, ",");
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::split_reuse(line, result, ","), 0);
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::rsplit_reuse(line, result, ",", 1), 0);
+    PYSTRING_CHECK_EQUAL(result[1], "another_long_field_name_beyond_sso");
+    pystring::partition(line, ",", result);
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::partition(line, ",", result), 0);
+    PYSTRING_CHECK_EQUAL(result[2], "another_long_field_name_beyond_sso");
+}
+
+PYSTRING_ADD_TEST(pystring, partition_view)
+{
+    constexpr pystring::partition_result parts = pystring::partition_view("shot.0001.exr", ".");
+    static_assert(parts.head == "shot" && parts.sep == "." && parts.tail == "0001.exr", "partition_view");
+    constexpr pystring::partition_result rparts = pystring::rpartition_view("shot.0001.exr", ".");
+    static_assert(rparts.head == "shot.0001" && rparts.tail == "exr", "rpartition_view");
+
+    auto [head, sep, tail] = pystring::partition_view("key = value", " = ");
+    PYSTRING_CHECK_EQUAL(head, "key");
+    PYSTRING_CHECK_EQUAL(sep, " = ");
+    PYSTRING_CHECK_EQUAL(tail, "value");
+
+    const char * samples[] = { "", "a", "a.b", ".a.", "a..b", "..." };
+    const char * seps[] = { ".", "..", "x" };
+    for (const char * sample : samples)
+    {
+        for (const char * s : seps)
+        {
+            std::vector<std::string> expected = pystring::partition(sample, s);
+            pystring::partition_result p = pystring::partition_view(sample, s);
+            PYSTRING_CHECK_EQUAL(std::string(p.head) + "|" + std::string(p.sep) + "|" + std::string(p.tail), pystring::join("|", expected));
+
+            expected = pystring::rpartition(sample, s);
+            p = pystring::rpartition_view(sample, s);
+            PYSTRING_CHECK_EQUAL(std::string(p.head) + "|" + std::string(p.sep) + "|" + std::string(p.tail), pystring::join("|", expected));
+        }
+    }
+
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::rpartition_view("a/b/c", "/"), 0);
+}
+
+PYSTRING_ADD_TEST(pystring, strip_view)
+{
+    PYSTRING_CHECK_EQUAL(pystring::strip_view("\r\n a b \t"), "a b");
+    PYSTRING_CHECK_EQUAL(pystring::lstrip_view("  a  "), "a  ");
+    PYSTRING_CHECK_EQUAL(pystring::rstrip_view("  a  "), "  a");
+    PYSTRING_CHECK_EQUAL(pystring::strip_view("xxaxyx", "xy"), "a");
+    PYSTRING_CHECK_EQUAL(pystring::strip_view("   "), "");
+    PYSTRING_CHECK_EQUAL(pystring::removeprefix_view("abcdef", "abc"), "def");
+    PYSTRING_CHECK_EQUAL(pystring::removeprefix_view("abcdef", "bcd"), "abcdef");
+    PYSTRING_CHECK_EQUAL(pystring::removeprefix_view("ab", "abc"), "ab");
+    PYSTRING_CHECK_EQUAL(pystring::removesuffix_view("abcdef", "def"), "abc");
+    PYSTRING_CHECK_EQUAL(pystring::removesuffix_view("abcdef", "cde"), "abcdef");
+    PYSTRING_CHECK_EQUAL(pystring::removesuffix_view("ef", "def"), "ef");
+    PYSTRING_CHECK_EQUAL(pystring::slice_view("abcdef", 2, -1), "cde");
+    PYSTRING_CHECK_EQUAL(pystring::slice_view("abcdef", -2), "ef");
+    PYSTRING_CHECK_EQUAL(pystring::slice_view("abcdef", 4, 2), "");
+    PYSTRING_CHECK_EQUAL(pystring::slice_view_64("abcdef", 1, 3), "bc");
+
+    // The views alias the input and agree with the owning versions.
+    std::string text = "   a line long enough to need a heap allocation if it were copied   ";
+    PYSTRING_CHECK_EQUAL(pystring::strip_view(text).data(), text.data() + 3);
+    const char * samples[] = { "", " ", "ab", " ab ", "xabx", "\tab\n", "abab", "ba" };
+    const char * args[] = { "", "x", "ab", "b", "abx" };
+    for (const char * sample : samples)
+    {
+        for (const char * arg : args)
+        {
+            PYSTRING_CHECK_EQUAL(pystring::strip_view(sample, arg), pystring::strip(sample, arg));
+            PYSTRING_CHECK_EQUAL(pystring::lstrip_view(sample, arg), pystring::lstrip(sample, arg));
+            PYSTRING_CHECK_EQUAL(pystring::rstrip_view(sample, arg), pystring::rstrip(sample, arg));
+            PYSTRING_CHECK_EQUAL(pystring::removeprefix_view(sample, arg), pystring::removeprefix(sample, arg));
+            PYSTRING_CHECK_EQUAL(pystring::removesuffix_view(sample, arg), pystring::removesuffix(sample, arg));
+        }
+        for (int start = -4; start <= 4; ++start)
+        {
+            for (int end = -4; end <= 4; ++end)
+            {
+                PYSTRING_CHECK_EQUAL(pystring::slice_view(sample, start, end), pystring::slice(sample, start, end));
+            }
+        }
+    }
+
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::strip_view(text), 0);
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::removesuffix_view(pystring::removeprefix_view(text, "   a"), "   "), 0);
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::slice_view(text, 3, -3), 0);
+
+    // Trimming the fields of a zero-copy split stays off the heap.
+    std::string row = "  alpha ,beta,   gamma with a long trailing value that would not fit inline   ";
+    pystring::small_vector<std::string_view, 8> fields;
+    std::size_t total = 0;
+    PYSTRING_CHECK_MAX_ALLOCS([&] {
+        pystring::split_view(row, fields, ",");
+        for (std::string_view field : fields) total += pystring::strip_view(field).size();
+    }(), 0);
+    PYSTRING_CHECK_EQUAL(total, 5u + 4u + 58u);
+}
+
+PYSTRING_ADD_TEST(pystring, charset)
+{
+    static constexpr pystring::CharSet separators(",;\t");
+    static_assert(separators.size() == 3 && separators.contains(';') && !separators.contains(' '), "CharSet");
+    static_assert(pystring::CharSet("aab").size() == 2 && pystring::CharSet().empty(), "CharSet");
+
+    PYSTRING_CHECK_EQUAL(pystring::strip(";a,b\t", separators), "a,b");
+    PYSTRING_CHECK_EQUAL(pystring::lstrip(";a,", separators), "a,");
+    PYSTRING_CHECK_EQUAL(pystring::rstrip(";a,", separators), ";a");
+    PYSTRING_CHECK_EQUAL(pystring::strip(",;", separators), "");
+    PYSTRING_CHECK_EQUAL(pystring::strip(" a ", pystring::CharSet()), " a ");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any("a,b;;c", separators)), "a|b||c");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any("a,b;;c", separators, -1, true)), "a|b|c");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::rsplit_any("a,b;c", separators, 1)), "a,b|c");
+
+    std::string identity(256, '\0');
+    for (int i = 0; i < 256; ++i) identity[i] = (char) i;
+    PYSTRING_CHECK_EQUAL(pystring::translate("a,b;c", identity, separators), "abc");
+    PYSTRING_CHECK_EQUAL(pystring::translate("\xe9t\xe9", identity, "\xe9"), "t");
+
+    // Runs longer than the 16 and 32 byte blocks, sets over eight members (the nibble lookup)
+    // and bytes above 0x7f must all agree with the character-list versions.
+    const char * lists[] = { "x", "xy", "abcdefgh", "abcdefghi", "0123456789 \t\x80\xff", "\xe9\xff" };
+    for (const char * list : lists)
+    {
+        pystring::CharSet set(list);
+        for (std::size_t pad = 0; pad < 70; pad += 3)
+        {
+            std::string edge;
+            for (std::size_t i = 0; i < pad; ++i) edge += list[i % std::strlen(list)];
+            const std::string samples[] = { edge, edge + "q" + edge, edge + "q" + edge + "r", "q" + edge + ",z" + edge };
+            for (const std::string & sample : samples)
+            {
+                PYSTRING_CHECK_EQUAL(pystring::strip(sample, set), pystring::strip(sample, list));
+                PYSTRING_CHECK_EQUAL(pystring::lstrip(sample, set), pystring::lstrip(sample, list));
+                PYSTRING_CHECK_EQUAL(pystring::rstrip(sample, set), pystring::rstrip(sample, list));
+                std::string kept;
+                for (char c : sample) if (!std::strchr(list, c)) kept += c;
+                PYSTRING_CHECK_EQUAL(pystring::translate(sample, identity, set), kept);
+                PYSTRING_CHECK_EQUAL(pystring::split_any(sample, set).size(), pystring::split_any(sample, list).size());
+            }
+        }
+    }
+
+    std::string text = "\t;  a line long enough to need a heap allocation if it were copied ;;\t";
+    PYSTRING_CHECK_EQUAL(pystring::strip_view(text, pystring::CharSet(" ;\t")), "a line long enough to need a heap allocation if it were copied");
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::strip_view(text, separators), 0);
+}
+
+PYSTRING_ADD_TEST(pystring, shlex)
+{
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("")), "");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("  a  b\tc\n")), "a|b|c");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("render -o 'my shot.exr' --note \"it's \\\"done\\\"\"")),
+                         "render|-o|my shot.exr|--note|it's \"done\"");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("a'b c'd \"\" ''")), "ab cd||");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("a\\ b \\'c\\\\")), "a b|'c\\");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("\"a\\b\\\\c\\$\"")), "a\\b\\c\\$");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::shlex_split("'a\\b' #x")), "a\\b|#x");
+
+    std::vector<std::string> result = { "stale" };
+    PYSTRING_CHECK_EQUAL(pystring::shlex_split("a 'b", result), false);
+    PYSTRING_CHECK_EQUAL(result.size(), 0);
+    PYSTRING_CHECK_EQUAL(pystring::shlex_split("a \"b\\\"", result), false);
+    PYSTRING_CHECK_EQUAL(pystring::shlex_split("a b\\", result), false);
+    PYSTRING_CHECK_EQUAL(pystring::shlex_split("a b", result), true);
+    PYSTRING_CHECK_EQUAL(result.size(), 2);
+
+    std::string buffer;
+    buffer.reserve(64);
+    pystring::small_vector<std::string_view, 8> words;
+    std::string line = "cp -r \"source dir\" plain/target 'x y'";
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::shlex_split_view(line, words, buffer), 0);
+    PYSTRING_CHECK_EQUAL(words.size(), 5);
+    PYSTRING_CHECK_EQUAL(words[2], "source dir");
+    PYSTRING_CHECK_EQUAL(words[3], "plain/target");
+    PYSTRING_CHECK_EQUAL(words[3].data(), line.data() + 19);
+    PYSTRING_CHECK_EQUAL(words[4], "x y");
+
+    PYSTRING_CHECK_EQUAL(pystring::shlex_quote(""), "''");
+    PYSTRING_CHECK_EQUAL(pystring::shlex_quote("plain/path-1.exr"), "plain/path-1.exr");
+    PYSTRING_CHECK_EQUAL(pystring::shlex_quote("my shot"), "'my shot'");
+    PYSTRING_CHECK_EQUAL(pystring::shlex_quote("it's"), "'it'\"'\"'s'");
+    std::vector<std::string> args = { "echo", "it's", "", "a b", "$HOME" };
+    PYSTRING_CHECK_EQUAL(pystring::shlex_join(args), "echo 'it'\"'\"'s' '' 'a b' '$HOME'");
+    PYSTRING_CHECK_EQUAL(pystring::shlex_split(pystring::shlex_join(args)) == args, true);
+}
+
+PYSTRING_ADD_TEST(pystring, split_any)
+{
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any("a,b;c", ",;")), "a|b|c");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any(",a,,b;", ",;")), "|a||b|");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any(",a,,b;", ",;", -1, true)), "a|b");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any("a,b;c", ",;", 1)), "a|b;c");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::rsplit_any("a,b;c", ",;", 1)), "a,b|c");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any(" ;a; b ;", " ;", 1, true)), "a|b ;");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::rsplit_any(" ;a; b ;", " ;", 1, true)), " ;a|b");
+    PYSTRING_CHECK_EQUAL(pystring::split_any("", ",").size(), 1);
+    PYSTRING_CHECK_EQUAL(pystring::split_any("", ",", -1, true).size(), 0);
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split_any("a,b", "")), "a,b");
+
+    // Long inputs go through the block kernels, with small and large separator sets.
+    std::string line;
+    for (int i = 0; i < 40; ++i) line += "field" + std::to_string(i) + (i % 3 ? ", " : "\t;");
+    const char * charsets[] = { ",", " ,", " \t,;", " \t,;|:!#&*+-=~^%@", "\x80\xff;" };
+    for (const char * chars : charsets)
+    {
+        // Splitting on any of chars matches splitting on one byte they have all been mapped to.
+        auto normalize = [chars](std::string s)
+        {
+            for (char & c : s)
+            {
+                if (strchr(chars, c)) c = '\x01';
+            }
+            return s;
+        };
+        std::string normalized = normalize(line);
+        for (int maxsplit = -1; maxsplit < 50; maxsplit += 7)
+        {
+            std::vector<std::string> expected = pystring::split(normalized, "\x01", maxsplit);
+            std::vector<std::string> actual = pystring::split_any(line, chars, maxsplit);
+            PYSTRING_CHECK_EQUAL(actual.size(), expected.size());
+            PYSTRING_CHECK_EQUAL(normalize(pystring::join("\x02", actual)), pystring::join("\x02", expected));
+
+            expected = pystring::rsplit(normalized, "\x01", maxsplit);
+            actual = pystring::rsplit_any(line, chars, maxsplit);
+            PYSTRING_CHECK_EQUAL(actual.size(), expected.size());
+            PYSTRING_CHECK_EQUAL(normalize(pystring::join("\x02", actual)), pystring::join("\x02", expected));
+        }
+    }
+
+    std::string spaced = "  alpha \t beta\n\ngamma  delta   epsilon\r\n zeta eta theta iota  ";
+    for (int maxsplit = -1; maxsplit < 10; ++maxsplit)
+    {
+        PYSTRING_CHECK_EQUAL(pystring::split_any(spaced, " \t\n\r\f\v", maxsplit, true) == pystring::split(spaced, "", maxsplit), true);
+        PYSTRING_CHECK_EQUAL(pystring::rsplit_any(spaced, " \t\n\r\f\v", maxsplit, true) == pystring::rsplit(spaced, "", maxsplit), true);
+    }
+}
+
+PYSTRING_ADD_TEST(pystring, intern)
+{
+    pystring::InternPool pool;
+    std::string a = "render01", b = "render01";
+    std::string_view ia = pool.intern(a);
+    std::string_view ib = pool.intern(b);
+    PYSTRING_CHECK_EQUAL(ia, "render01");
+    PYSTRING_CHECK_EQUAL(ia.data() == ib.data(), true);
+    PYSTRING_CHECK_EQUAL(ia.data() != a.data(), true);
+    PYSTRING_CHECK_EQUAL(pool.intern("render02").data() != ia.data(), true);
+    PYSTRING_CHECK_EQUAL(pool.intern("").size(), 0);
+    PYSTRING_CHECK_EQUAL(pool.intern("").data() == pool.intern(std::string_view()).data(), true);
+    PYSTRING_CHECK_EQUAL(pool.size(), 2);
+    PYSTRING_CHECK_MAX_ALLOCS(pool.intern(b), 0);
+
+    std::string big(100000, 'x');
+    PYSTRING_CHECK_EQUAL(pool.intern(big).size(), big.size());
+    PYSTRING_CHECK_EQUAL(pool.intern(big).data() == pool.intern(std::string(big)).data(), true);
+
+    // Strings larger than the first shard block, and enough of them to grow it to full size.
+    std::vector<std::string_view> mid;
+    for (int i = 0; i < 200; ++i) mid.push_back(pool.intern(std::string(3000 + i, char('a' + i % 26))));
+    for (int i = 0; i < 200; ++i) PYSTRING_CHECK_EQUAL(mid[i], std::string(3000 + i, char('a' + i % 26)));
+    PYSTRING_CHECK_EQUAL(pool.intern(std::string(3000, 'a')).data() == mid[0].data(), true);
+
+    std::vector<std::string_view> fields;
+    pystring::split_intern("GET /index.html 200 host1", fields, pool);
+    std::vector<std::string_view> again;
+    pystring::split_intern("POST /index.html 404 host1", again, pool, " ");
+    PYSTRING_CHECK_EQUAL(fields.size(), 4);
+    PYSTRING_CHECK_EQUAL(fields[1], "/index.html");
+    PYSTRING_CHECK_EQUAL(fields[1].data() == again[1].data(), true);
+    PYSTRING_CHECK_EQUAL(fields[3].data() == again[3].data(), true);
+
+    // Threads interning overlapping sets agree on a single copy of each string.
+    pystring::InternPool shared;
+    std::vector<std::vector<std::string_view>> seen(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&shared, &seen, t]()
+        {
+            for (int i = 0; i < 5000; ++i)
+            {
+                seen[t].push_back(shared.intern("host" + std::to_string((i * (t + 1)) % 5000)));
+            }
+        });
+    }
+    for (std::thread & thread : threads) thread.join();
+    PYSTRING_CHECK_EQUAL(shared.size(), 5000);
+    bool consistent = true;
+    for (int t = 1; t < 4; ++t)
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            std::string_view mine = seen[t][i];
+            std::string_view other = shared.intern(std::string(mine));
+            consistent = consistent && mine.data() == other.data() && mine == "host" + std::to_string((i * (t + 1)) % 5000);
+        }
+    }
+    PYSTRING_CHECK_EQUAL(consistent, true);
+}
+
+PYSTRING_ADD_TEST(pystring, ascii_classification)
+{
+    // Classification follows the C locale's ASCII rules for every byte, whatever the global
+    // locale, and bytes >= 0x80 (negative chars) have no properties and no case.
+    PYSTRING_CHECK_EQUAL(pystring::isalpha("\xe9t\xe9"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isalnum("\xff"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isspace("\xa0\x85"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isspace(" \t\n\v\f\r"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isdigit("0123456789"), true);
+    PYSTRING_CHECK_EQUAL(pystring::islower("abc\xe9"), false);
+    PYSTRING_CHECK_EQUAL(pystring::lower("ABC\xc9"), "abc\xc9");
+    PYSTRING_CHECK_EQUAL(pystring::upper("abc\xe9"), "ABC\xe9");
+    PYSTRING_CHECK_EQUAL(pystring::swapcase("aB\xe9\xc9"), "Ab\xe9\xc9");
+    PYSTRING_CHECK_EQUAL(pystring::capitalize("\xe9" "COLE"), "\xe9" "cole");
+    PYSTRING_CHECK_EQUAL(pystring::title("hello wORLD \xe9t\xe9"), "Hello World \xe9T\xe9");
+    PYSTRING_CHECK_EQUAL(pystring::strip("\xa0 x \xa0"), "\xa0 x \xa0");
+    PYSTRING_CHECK_EQUAL(pystring::join("|", pystring::split("a\xa0" "b c")), "a\xa0" "b|c");
+
+    for (int c = 0; c < 256; ++c)
+    {
+        std::string s(1, (char) c);
+        bool upper = c >= 'A' && c <= 'Z', lower = c >= 'a' && c <= 'z', digit = c >= '0' && c <= '9';
+        bool space = c == ' ' || (c >= '\t' && c <= '\r');
+        if (pystring::isupper(s) != upper || pystring::islower(s) != lower || pystring::isdigit(s) != digit ||
+            pystring::isspace(s) != space || pystring::isalpha(s) != (upper || lower) ||
+            pystring::isalnum(s) != (upper || lower || digit) ||
+            pystring::lower(s) != std::string(1, (char) (upper ? c + 32 : c)) ||
+            pystring::upper(s) != std::string(1, (char) (lower ? c - 32 : c)))
+        {
+            PYSTRING_CHECK_EQUAL(c, -1);
+        }
+    }
+}
+
+PYSTRING_ADD_TEST(pystring, predicates)
+{
+    PYSTRING_CHECK_EQUAL(pystring::isascii(""), true);
+    PYSTRING_CHECK_EQUAL(pystring::isascii("abc\x7f"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isascii("abc\x80"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isprintable(""), true);
+    PYSTRING_CHECK_EQUAL(pystring::isprintable(" ~"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isprintable("a\tb"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isprintable("a\x7f"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isdecimal(""), false);
+    PYSTRING_CHECK_EQUAL(pystring::isdecimal("0123"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isdecimal("1.5"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isidentifier(""), false);
+    PYSTRING_CHECK_EQUAL(pystring::isidentifier("_"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isidentifier("_private9"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isidentifier("9lives"), false);
+    PYSTRING_CHECK_EQUAL(pystring::isidentifier("a-b"), false);
+    PYSTRING_CHECK_EQUAL(pystring::istitle(""), false);
+    PYSTRING_CHECK_EQUAL(pystring::istitle("A"), true);
+    PYSTRING_CHECK_EQUAL(pystring::istitle("a"), false);
+    PYSTRING_CHECK_EQUAL(pystring::istitle("1"), false);
+
+    // Long inputs cross the 16 and 32 byte blocks: one bad byte anywhere must be found, and
+    // the cased state carries across block boundaries in istitle.
+    for (std::size_t len = 1; len <= 70; ++len)
+    {
+        for (std::size_t pos = 0; pos < len; ++pos)
+        {
+            std::string digits(len, '7'), bad = digits;
+            bad[pos] = '/';
+            std::string ident(len, '_'), title(len, 'x');
+            ident[pos] = '.';
+            title[0] = 'T';
+            title[pos] = pos ? 'U' : 'T';
+            std::string upper(len, 'Q');
+            upper[pos] = '\x80';
+            if (!pystring::isdigit(digits) || pystring::isdigit(bad) || pystring::isdecimal(bad) ||
+                pystring::isidentifier(ident) || pystring::isupper(upper) || pystring::isascii(upper) ||
+                !pystring::isalnum(digits + std::string(len, 'z')) || pystring::istitle(title) != (pos == 0))
+            {
+                PYSTRING_CHECK_EQUAL(len * 100 + pos, 0u);
+            }
+        }
+    }
+
+    std::string words;
+    for (int i = 0; i < 20; ++i) words += "Word ";
+    PYSTRING_CHECK_EQUAL(pystring::istitle(words), true);
+    PYSTRING_CHECK_EQUAL(pystring::istitle(words + "word"), false);
+    PYSTRING_CHECK_EQUAL(pystring::istitle(std::string(15, ' ') + "Ab" + std::string(40, 'c')), true);
+    PYSTRING_CHECK_EQUAL(pystring::istitle(std::string(15, 'A') + "b"), false);
+    PYSTRING_CHECK_EQUAL(pystring::istitle(std::string(40, ' ')), false);
+    PYSTRING_CHECK_EQUAL(pystring::isspace(std::string(40, ' ') + "\t\n\v\f\r"), true);
+    PYSTRING_CHECK_EQUAL(pystring::isprintable(std::string(40, ' ') + "\n"), false);
+}
+
+PYSTRING_ADD_TEST(pystring, string_column)
+{
+    pystring::StringColumn column;
+    PYSTRING_CHECK_EQUAL(column.size(), 0u);
+    PYSTRING_CHECK_EQUAL(column.offsets()[0], 0u);
+    PYSTRING_CHECK_EQUAL(pystring::join(",", column), "");
+
+    PYSTRING_CHECK_EQUAL(column.append("ab"), true);
+    PYSTRING_CHECK_EQUAL(column.append(""), true);
+    PYSTRING_CHECK_EQUAL(column.append("cde"), true);
+    PYSTRING_CHECK_EQUAL(column.size(), 3u);
+    PYSTRING_CHECK_EQUAL(column[1], "");
+    PYSTRING_CHECK_EQUAL(column.back(), "cde");
+    PYSTRING_CHECK_EQUAL(column.bytes(), "abcde");
+    PYSTRING_CHECK_EQUAL(column.offsets()[3], 5u);
+    PYSTRING_CHECK_EQUAL(pystring::join("-", column), "ab--cde");
+    PYSTRING_CHECK_EQUAL(pystring::join("", column), "abcde");
+
+    std::string seen;
+    for (std::string_view s : column) seen += "[" + std::string(s) + "]";
+    PYSTRING_CHECK_EQUAL(seen, "[ab][][cde]");
+
+    const char * inputs[] = { "", "  a  b\tc ", "a,,b,", "one", ",", "x\r\ny\n\nz" };
+    const char * seps[] = { "", ",", ",," };
+    for (const char * input : inputs)
+    {
+        for (const char * sep : seps)
+        {
+            for (int maxsplit = -1; maxsplit < 3; ++maxsplit)
+            {
+                pystring::LargeStringColumn large;
+                PYSTRING_CHECK_EQUAL(pystring::split_to_column(input, column, sep, maxsplit), true);
+                PYSTRING_CHECK_EQUAL(pystring::split_to_column(input, large, sep, maxsplit), true);
+                std::vector<std::string> expected = pystring::split(input, sep, maxsplit);
+                PYSTRING_CHECK_EQUAL(column.size(), expected.size());
+                PYSTRING_CHECK_EQUAL(large.size(), expected.size());
+                PYSTRING_CHECK_EQUAL(pystring::join("|", column), pystring::join("|", expected));
+                PYSTRING_CHECK_EQUAL(pystring::join("|", large), pystring::join("|", expected));
+            }
+        }
+        for (bool keepends : { false, true })
+        {
+            PYSTRING_CHECK_EQUAL(pystring::splitlines_to_column(input, column, keepends), true);
+            std::vector<std::string> expected = pystring::splitlines(input, keepends);
+            PYSTRING_CHECK_EQUAL(column.size(), expected.size());
+            PYSTRING_CHECK_EQUAL(pystring::join("|", column), pystring::join("|", expected));
+        }
+    }
+
+    // Bulk splitting sizes the column once: one block for the data and one for the offsets.
+    std::string text;
+    for (int i = 0; i < 1000; ++i) text += "token" + std::to_string(i) + " ";
+    pystring::StringColumn tokens;
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::split_to_column(text, tokens), 2);
+    PYSTRING_CHECK_EQUAL(tokens.size(), 1000u);
+    PYSTRING_CHECK_EQUAL(tokens[999], "token999");
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::split_to_column(text, tokens), 0);
+}
+
+PYSTRING_ADD_TEST(pystring, batch)
+{
+    std::vector<std::string_view> strs = { "", "  Mixed Case  ", "-42", "+7", "12", "a.b.c", "/usr//local/./lib/../bin/",
+                                           "//net/x", "///abs", "../a/../../b", ".", "x/", "xx\tyy", "aaaa",
+                                           "/Shows/A Longer Path/With Mixed CASE/Past The Vector Width/aaa.exr" };
+    pystring::StringColumn column;
+    for (std::string_view s : strs) column.append(s);
+
+    pystring::StringColumn out;
+    pystring::LargeStringColumn large;
+    for (int source = 0; source < 2; ++source)
+    {
+        pystring::batch::StringSpan span = source ? pystring::batch::StringSpan(column) : pystring::batch::StringSpan(strs);
+        PYSTRING_CHECK_EQUAL(span.size(), strs.size());
+        PYSTRING_CHECK_EQUAL(span.total_bytes(), column.bytes().size());
+
+        struct Case { std::function<bool()> run; std::function<std::string(std::string_view)> expect; };
+        std::vector<Case> cases = {
+            { [&] { return pystring::batch::strip(span, out); }, [](std::string_view s) { return pystring::strip(s); } },
+            { [&] { return pystring::batch::strip(span, out, "a/"); }, [](std::string_view s) { return pystring::strip(s, "a/"); } },
+            { [&] { return pystring::batch::lower(span, out); }, [](std::string_view s) { return pystring::lower(s); } },
+            { [&] { return pystring::batch::replace(span, out, "a", "XYZ"); }, [](std::string_view s) { return pystring::replace(s, "a", "XYZ"); } },
+            { [&] { return pystring::batch::replace(span, out, "/", "", 2); }, [](std::string_view s) { return pystring::replace(s, "/", "", 2); } },
+            { [&] { return pystring::batch::replace(span, out, "/", "\\"); }, [](std::string_view s) { return pystring::replace(s, "/", "\\"); } },
+            { [&] { return pystring::batch::replace(span, out, "/", "|", 2); }, [](std::string_view s) { return pystring::replace(s, "/", "|", 2); } },
+            { [&] { return pystring::batch::replace(span, out, "aa", "bc"); }, [](std::string_view s) { return pystring::replace(s, "aa", "bc"); } },
+            { [&] { return pystring::batch::replace(span, out, "", "-"); }, [](std::string_view s) { return pystring::replace(s, "", "-"); } },
+            { [&] { return pystring::batch::replace(span, out, "", "-", 3); }, [](std::string_view s) { return pystring::replace(s, "", "-", 3); } },
+            { [&] { return pystring::batch::zfill(span, out, 5); }, [](std::string_view s) { return pystring::zfill(s, 5); } },
+            { [&] { return pystring::batch::normpath(span, out); }, [](std::string_view s) { return pystring::os::path::normpath(s); } },
+            { [&] { return pystring::batch::basename(span, out); }, [](std::string_view s) { return pystring::os::path::basename(s); } },
+        };
+        for (const Case & c : cases)
+        {
+            PYSTRING_CHECK_EQUAL(c.run(), true);
+            PYSTRING_CHECK_EQUAL(out.size(), strs.size());
+            for (std::size_t i = 0; i < strs.size(); ++i) PYSTRING_CHECK_EQUAL(out[i], c.expect(strs[i]));
+        }
+
+        PYSTRING_CHECK_EQUAL(pystring::batch::zfill(span, large, 3), true);
+        PYSTRING_CHECK_EQUAL(large[2], "-42");
+        PYSTRING_CHECK_EQUAL(large[4], "012");
+    }
+
+    // A batch writes into the column's two growing buffers instead of allocating per string,
+    // and a warm column is reused without allocating.
+    std::vector<std::string> paths;
+    for (int i = 0; i < 500; ++i) paths.push_back("/data/./shots/" + std::to_string(i) + "/../frame." + std::to_string(i) + ".exr");
+    std::vector<std::string_view> views(paths.begin(), paths.end());
+    pystring::StringColumn result;
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::batch::normpath(views, result), 2);
+    PYSTRING_CHECK_EQUAL(result[7], "/data/shots/frame.7.exr");
+    PYSTRING_CHECK_MAX_ALLOCS(pystring::batch::basename(views, result), 0);
+    PYSTRING_CHECK_EQUAL(result[499], "frame.499.exr");
+}
+
+PYSTRING_ADD_TEST(pystring, string_builder)
+{
+    pystring::StringBuilder builder;
+    PYSTRING_CHECK_EQUAL(builder.empty(), true);
+    PYSTRING_CHECK_EQUAL(builder.str(), "");
+
+    std::string borrowed = "<view>";
+    std::vector<std::string> seq = { "a", "", "bc" };
+    builder.append("head ");
+    builder.append_view(borrowed);
+    builder.append_join(", ", seq);
+    builder.append_join(", ", std::vector<std::string>());
+    builder.append_padded("x", 5);
+    builder.append_padded("x", 5, '>', '.');
+    builder.append_padded("ab", 7, '^', '*');
+    builder.append_padded("toolong", 3, '^');
+    builder.append_replace("a-b-c-d", "-", "+-+", 2);
+    builder.append_replace("ab", "", "|");
+
+    std::string expected = std::string("head ") + "<view>" + pystring::join(", ", seq) + pystring::ljust("x", 5) +
+                           "....x" + "***ab**" + "toolong" + pystring::replace("a-b-c-d", "-", "+-+", 2) +
+                           pystring::replace("ab", "", "|");
+    PYSTRING_CHECK_EQUAL(builder.size(), expected.size());
+    PYSTRING_CHECK_EQUAL(builder.str(), expected);
+
+    for (int width = 0; width < 8; ++width)
+    {
+        pystring::StringBuilder padded;
+        padded.append_padded("ab", width, '^');
+        padded.append_padded("abc", width, '>');
+        PYSTRING_CHECK_EQUAL(padded.str(), pystring::center("ab", width) + pystring::rjust("abc", width));
+    }
+
+    std::string out = "prefix:";
+    builder.str_into(out);
+    PYSTRING_CHECK_EQUAL(out, "prefix:" + expected);
+
+    const char * replace_inputs[] = { "", "aaa", "abcabc", "xyz" };
+    for (const char * input : replace_inputs)
+    {
+        for (int count = -1; count < 4; ++count)
+        {
+            pystring::StringBuilder r;
+            r.append_replace(input, "", "-", count);
+            r.append_replace(input, "a", "AA", count);
+            PYSTRING_CHECK_EQUAL(r.str(), pystring::replace(input, "", "-", count) + pystring::replace(input, "a", "AA", count));
+        }
+    }
+
+    // Many small appends gather into a few arena blocks, and flattening allocates once.
+    builder.clear();
+    PYSTRING_CHECK_EQUAL(builder.size(), 0u);
+    std::string flat;
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string piece = std::to_string(i) + ",";
+        builder.append(piece);
+        flat += piece;
+    }
+    builder.append_view(borrowed);
+    flat += borrowed;
+    std::string result;
+    PYSTRING_CHECK_MAX_ALLOCS(builder.str_into(result), 1);
+    PYSTRING_CHECK_EQUAL(result, flat);
+
+#if !defined(_WIN32)
+    std::FILE * file = std::tmpfile();
+    PYSTRING_CHECK_EQUAL(file != nullptr, true);
+    if (file)
+    {
+        PYSTRING_CHECK_EQUAL(builder.write(fileno(file)), true);
+        std::string written(flat.size() + 1, '\0');
+        std::fseek(file, 0, SEEK_SET);
+        written.resize(std::fread(&written[0], 1, written.size(), file));
+        PYSTRING_CHECK_EQUAL(written, flat);
+        std::fclose(file);
+    }
+    PYSTRING_CHECK_EQUAL(builder.write(-1), false);
+#endif
+}
+
+PYSTRING_ADD_TEST(pystring, isa)
+{
+    const pystring::isa levels[] = { pystring::isa::scalar, pystring::isa::sse2, pystring::isa::avx2 };
+    pystring::isa initial = pystring::selected_isa();
+    PYSTRING_CHECK_EQUAL(pystring::isa_supported(pystring::isa::scalar), true);
+    PYSTRING_CHECK_EQUAL(pystring::isa_supported(initial), true);
+    PYSTRING_CHECK_EQUAL(std::string(pystring::isa_name(pystring::isa::sse2)), "sse2");
+
+    // The per-ISA ctest runs set PYSTRING_FORCE_ISA; a supported level must have been selected.
+    if (const char * forced = std::getenv("PYSTRING_FORCE_ISA"))
+    {
+        for (pystring::isa level : levels)
+        {
+            if (forced == std::string(pystring::isa_name(level)) && pystring::isa_supported(level))
+            {
+                PYSTRING_CHECK_EQUAL(std::string(pystring::isa_name(initial)), pystring::isa_name(level));
+            }
+        }
+    }
+
+    // Every variant must agree with the scalar reference. Lengths run past the 16, 32 and 64
+    // byte block sizes, with bytes from each class boundary and above 0x7f.
+    const char alphabet[] = "aAzZ09_ ~\t\r\x7f\x80\xff@[`{/.,xyzQ";
+    std::vector<std::string> inputs;
+    unsigned state = 12345;
+    for (std::size_t len = 0; len < 200; len += (len < 70 ? 1 : 13))
+    {
+        for (int variant = 0; variant < 4; ++variant)
+        {
+            std::string s;
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                state = state * 1103515245u + 12345u;
+                std::size_t pick = (state >> 16) % (sizeof(alphabet) - 1);
+                // Narrow alphabets keep the all-lanes predicates true over long runs.
+                if (variant == 1) pick %= 2;
+                if (variant == 2) pick = 4 + pick % 2;
+                s += alphabet[pick];
+            }
+            if (variant == 3) s = pystring::title(s);
+            inputs.push_back(s);
+        }
+    }
+
+    std::string rot(256, '\0');
+    for (int i = 0; i < 256; ++i) rot[i] = (char) (i * 7 + 3);
+
+    // More than eight members, so the wide kernels take the nibble lookup.
+    const pystring::CharSet wide("aA09_ \t\x80\xff@.");
+
+    auto run = [&]()
+    {
+        std::string out;
+        for (const std::string & s : inputs)
+        {
+            bool flags[] = { pystring::isalnum(s), pystring::isalpha(s), pystring::isascii(s), pystring::isdigit(s),
+                             pystring::isidentifier(s), pystring::islower(s), pystring::isprintable(s), pystring::isspace(s),
+                             pystring::istitle(s), pystring::isupper(s) };
+            for (bool flag : flags) out += flag ? '1' : '0';
+            out += "|" + pystring::lower(s) + "|" + pystring::upper(s) + "|" + pystring::swapcase(s) + "|" + pystring::translate(s, rot);
+            out += "|" + std::to_string(pystring::count(s, "a")) + "," + std::to_string(pystring::count(s, "\xff", 3, -2));
+            out += "|" + std::to_string(pystring::rfind(s, "A")) + "," + std::to_string(pystring::rfind(s, "a0"));
+            out += "|" + std::to_string(pystring::ifind(s, "az")) + "," + std::to_string(pystring::irfind(s, "Za"));
+            out += "|" + std::to_string(pystring::icompare(s, pystring::upper(s)));
+            out += "|" + pystring::strip(s, "xyzQ") + "|" + pystring::join(";", pystring::split_any(s, "/.,"));
+            out += "|" + pystring::lstrip(s, wide) + "|" + pystring::rstrip(s, wide) + "|" + pystring::translate(s, rot, wide);
+            out += "|" + pystring::join(";", pystring::rsplit_any(s, wide, 3)) + "|" + pystring::translate(s, rot, "zZ");
+            out += "|" + std::to_string(pystring::utf8::isvalid(s)) + "\n";
+        }
+        return out;
+    };
+
+    pystring::force_isa(pystring::isa::scalar);
+    PYSTRING_CHECK_EQUAL(std::string(pystring::isa_name(pystring::selected_isa())), "scalar");
+    const std::string reference = run();
+    for (pystring::isa level : levels)
+    {
+        if (!pystring::force_isa(level)) continue;
+        PYSTRING_CHECK_EQUAL(std::string(pystring::isa_name(pystring::selected_isa())), pystring::isa_name(level));
+        PYSTRING_CHECK_EQUAL(run() == reference, true);
+    }
+    PYSTRING_CHECK_EQUAL(pystring::force_isa(initial), true);
 }
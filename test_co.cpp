@@ -0,0 +1,104 @@
+// Copyright Contributors to the Pystring project.
+// SPDX-License-Identifier: BSD-3-Clause
+// https://github.com/imageworks/pystring/blob/master/LICENSE
+
+
+#include "pystring_co.h"
+#include "unittest.h"
+
+#include <cstdio>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+PYSTRING_TEST_APP(PyStringCoroutineTests)
+
+#if defined(PYSTRING_HAVE_COROUTINES)
+
+static std::string collect(pystring::co::generator<std::string_view> gen)
+{
+    std::string result;
+    for (std::string_view item : gen)
+    {
+        result += '[';
+        result += item;
+        result += ']';
+    }
+    return result;
+}
+
+static std::string expected_lines(std::string_view text, bool keepends)
+{
+    std::string result;
+    for (const std::string & line : pystring::splitlines(text, keepends))
+    {
+        result += '[';
+        result += line;
+        result += ']';
+    }
+    return result;
+}
+
+PYSTRING_ADD_TEST(co, lines)
+{
+    const char * inputs[] = { "", "one", "a\nb", "a\r\nb\r\n", "\n\n", "x\ry\r", "\r", "\r\n", "trailing\n\r",
+                              "a long line that is longer than the buffer\nshort\r\nand another long one at the end" };
+    for (const char * input : inputs)
+    {
+        for (bool keepends : { false, true })
+        {
+            // Small buffers put line breaks, including a split "\r\n", on refill boundaries.
+            for (std::size_t buffer_size : { std::size_t(2), std::size_t(3), std::size_t(7), pystring::co::default_buffer_size })
+            {
+                std::istringstream in(input);
+                PYSTRING_CHECK_EQUAL(collect(pystring::co::lines(in, keepends, buffer_size)), expected_lines(input, keepends));
+            }
+        }
+    }
+
+    // Lines are views into the generator's buffer: reading a long input costs the coroutine
+    // frame and the buffer, not an allocation per line.
+    std::string text;
+    for (int i = 0; i < 5000; ++i) text += "line " + std::to_string(i) + "\n";
+    std::istringstream in(text);
+    std::size_t count = 0, bytes = 0;
+    PYSTRING_CHECK_MAX_ALLOCS([&] {
+        for (std::string_view line : pystring::co::lines(in, false, 4096)) { ++count; bytes += line.size(); }
+    }(), 2);
+    PYSTRING_CHECK_EQUAL(count, 5000u);
+    PYSTRING_CHECK_EQUAL(bytes, text.size() - 5000);
+}
+
+PYSTRING_ADD_TEST(co, fields)
+{
+    std::istringstream in("a b  c\n\nd,e\n f ");
+    PYSTRING_CHECK_EQUAL(collect(pystring::co::fields(pystring::co::lines(in))), "[a][b][c][d,e][f]");
+
+    std::istringstream csv("a,b,c\n1,,3\nx");
+    PYSTRING_CHECK_EQUAL(collect(pystring::co::fields(pystring::co::lines(csv), ",", 1)), "[a][b,c][1][,3][x]");
+
+    // Stages chain without materializing the lines.
+    std::istringstream words("alpha beta\ngamma\n");
+    std::size_t total = 0;
+    for (std::string_view field : pystring::co::fields(pystring::co::lines(words))) total += field.size();
+    PYSTRING_CHECK_EQUAL(total, 14u);
+}
+
+#if !defined(_WIN32)
+PYSTRING_ADD_TEST(co, lines_fd)
+{
+    int fds[2];
+    PYSTRING_CHECK_EQUAL(pipe(fds), 0);
+    std::string text = "first\nsecond\r\nthird";
+    PYSTRING_CHECK_EQUAL(write(fds[1], text.data(), text.size()), (ssize_t) text.size());
+    close(fds[1]);
+    PYSTRING_CHECK_EQUAL(collect(pystring::co::lines(fds[0], true, 4)), "[first\n][second\r\n][third]");
+    close(fds[0]);
+
+    PYSTRING_CHECK_EQUAL(collect(pystring::co::lines(-1)), "");
+}
+#endif
+
+#endif // PYSTRING_HAVE_COROUTINES
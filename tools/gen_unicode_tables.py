@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+# Copyright Contributors to the Pystring project.
+# SPDX-License-Identifier: BSD-3-Clause
+# https://github.com/imageworks/pystring/blob/master/LICENSE
+
+"""Generate pystring_unicode_tables.h from the running interpreter's
+unicodedata, so pystring::utf8 matches python's str methods for that
+Unicode version.
+
+Usage: python3 tools/gen_unicode_tables.py > pystring_unicode_tables.h
+
+Only code points >= 0x80 are described; ASCII is handled by the byte
+functions. Properties are stored as sorted [first, last] runs and case mappings as
+runs of code points sharing a delta. Both carry a stride of 1 or 2 to fold
+the alternating upper/lower blocks (Latin Extended, Cyrillic...).
+"""
+
+import sys
+import unicodedata
+
+MAX_CP = 0x110000
+
+
+def chars():
+    for cp in range(0x80, MAX_CP):
+        if 0xD800 <= cp <= 0xDFFF:
+            continue
+        yield cp, chr(cp)
+
+
+def ranges(pred):
+    """Collect the code points matching pred into (first, last, stride) runs."""
+    out = []
+    for cp, c in chars():
+        if not pred(c):
+            continue
+        if out:
+            first, last, stride = out[-1]
+            if first == last and cp - last in (1, 2):
+                out[-1] = [first, cp, cp - last]
+                continue
+            if cp - last == stride:
+                out[-1][1] = cp
+                continue
+        out.append([cp, cp, 1])
+    return out
+
+
+def simple_lower(c):
+    if c == 'İ':
+        return 'i'
+    low = c.lower()
+    return low if len(low) == 1 else c
+
+
+def simple_upper(c):
+    up = c.upper()
+    if len(up) == 1:
+        return up
+    # Characters whose full uppercase mapping expands (e.g. the Greek
+    # iota-subscript forms) have their titlecase form as simple mapping.
+    title = c.title()
+    if len(title) == 1 and title != c:
+        return title
+    return c
+
+
+def simple_title(c):
+    title = c.title()
+    return title if len(title) == 1 else simple_upper(c)
+
+
+def runs(mapping):
+    """Compress {cp: target} into (first, last, delta, stride) runs."""
+    items = sorted(mapping.items())
+    out = []
+    for cp, to in items:
+        delta = to - cp
+        if out:
+            first, last, d, stride = out[-1]
+            if d == delta:
+                if first == last and cp - last in (1, 2):
+                    out[-1] = [first, cp, d, cp - last]
+                    continue
+                if cp - last == stride:
+                    out[-1][1] = cp
+                    continue
+        out.append([cp, cp, delta, 1])
+    return out
+
+
+def mapping(fn):
+    m = {}
+    for cp, c in chars():
+        to = fn(c)
+        if to != c:
+            m[cp] = ord(to)
+    return m
+
+
+def emit_ranges(name, rs):
+    print('    inline constexpr unicode_range %s[] = {' % name)
+    for first, last, stride in rs:
+        print('        { 0x%04X, 0x%04X, %d },' % (first, last, stride))
+    print('    };')
+    print()
+
+
+def emit_runs(name, rs):
+    print('    inline constexpr unicode_case_run %s[] = {' % name)
+    for first, last, delta, stride in rs:
+        print('        { 0x%04X, 0x%04X, %d, %d },' % (first, last, delta, stride))
+    print('    };')
+    print()
+
+
+def main():
+    alpha = ranges(str.isalpha)
+    digit = ranges(lambda c: unicodedata.category(c) == 'Nd')
+    space = ranges(str.isspace)
+    lower = ranges(str.islower)
+    upper = ranges(str.isupper)
+    title = ranges(lambda c: unicodedata.category(c) == 'Lt')
+
+    to_lower = mapping(simple_lower)
+    to_upper = mapping(simple_upper)
+    # Titlecase is stored only where it differs from the uppercase mapping.
+    to_title = {}
+    for cp, c in chars():
+        t = ord(simple_title(c))
+        if t != to_upper.get(cp, cp):
+            to_title[cp] = t
+
+    fold_single = {}
+    fold_multi = []
+    for cp, c in chars():
+        f = c.casefold()
+        if len(f) == 1:
+            # Only store where folding differs from the simple lowercase.
+            if to_lower.get(cp, cp) != ord(f):
+                fold_single[cp] = ord(f)
+        else:
+            assert len(f) <= 3
+            fold_multi.append((cp, [ord(x) for x in f]))
+
+    print('// Copyright Contributors to the Pystring project.')
+    print('// SPDX-License-Identifier: BSD-3-Clause')
+    print('// https://github.com/imageworks/pystring/blob/master/LICENSE')
+    print()
+    print('// Generated by tools/gen_unicode_tables.py from Unicode %s. Do not edit.'
+          % unicodedata.unidata_version)
+    print()
+    print('#ifndef INCLUDED_PYSTRING_UNICODE_TABLES_H')
+    print('#define INCLUDED_PYSTRING_UNICODE_TABLES_H')
+    print()
+    print('namespace pystring')
+    print('{')
+    print('namespace unicode_data')
+    print('{')
+    print('    struct unicode_range { char32_t first, last; int stride; };')
+    print('    struct unicode_case_run { char32_t first, last; int delta; int stride; };')
+    print('    struct unicode_fold_special { char32_t cp; char32_t to[3]; };')
+    print()
+    emit_ranges('alpha_ranges', alpha)
+    emit_ranges('digit_ranges', digit)
+    emit_ranges('space_ranges', space)
+    emit_ranges('lower_ranges', lower)
+    emit_ranges('upper_ranges', upper)
+    emit_ranges('title_ranges', title)
+    emit_runs('to_lower_runs', runs(to_lower))
+    emit_runs('to_upper_runs', runs(to_upper))
+    emit_runs('to_title_runs', runs(to_title))
+    emit_runs('fold_runs', runs(fold_single))
+    print('    inline constexpr unicode_fold_special fold_specials[] = {')
+    for cp, to in fold_multi:
+        to = to + [0] * (3 - len(to))
+        print('        { 0x%04X, { 0x%04X, 0x%04X, 0x%04X } },' % (cp, to[0], to[1], to[2]))
+    print('    };')
+    print()
+    print('} // namespace unicode_data')
+    print('} // namespace pystring')
+    print()
+    print('#endif')
+
+
+if __name__ == '__main__':
+    sys.exit(main())
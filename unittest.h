@@ -5,12 +5,21 @@
 #ifndef INCLUDED_PYSTRING_UNITTEST_H
 #define INCLUDED_PYSTRING_UNITTEST_H
 
-#include <iostream>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
 #include <vector>
 
 extern int unit_test_failures;
 
+/// Number of calls made to the global operator new since the test binary
+/// started. Only counted when the binary expands PYSTRING_TEST_APP (or
+/// PYSTRING_ALLOCATION_HOOKS directly), so the library itself never pays
+/// for the bookkeeping.
+extern std::atomic<std::size_t> unit_test_allocations;
+
 void unittest_fail();
 
 typedef void (*PYSTRINGTestFunc)();
@@ -100,6 +109,19 @@ struct AddTest { AddTest(PYSTRINGTest* test); };
         << "FAILED: exception thrown from " << #S <<"\n";               \
         ++unit_test_failures; }
 
+/// PYSTRING_CHECK_MAX_ALLOCS evaluates x and fails if doing so performed more
+/// than n heap allocations. Use it to pin down the non-allocating paths so a
+/// change that reintroduces heap traffic shows up as a test failure.
+#define PYSTRING_CHECK_MAX_ALLOCS(x, n)                                     \
+    do { std::size_t _allocs_before = unit_test_allocations.load();     \
+        (void)(x);                                                      \
+        std::size_t _allocs = unit_test_allocations.load() - _allocs_before; \
+        if (_allocs > (std::size_t)(n)) {                               \
+            std::cout << __FILE__ << ":" << __LINE__ << ":\n"           \
+            << "FAILED: " << #x << " allocates at most " << #n << " times\n" \
+            << "\tallocations were '" << _allocs << "'\n";              \
+            ++unit_test_failures; } } while (0)
+
 #define PYSTRING_ADD_TEST(group, name)                                      \
     static void pystringtest_##group##_##name();                            \
     AddTest pystringaddtest_##group##_##name(new PYSTRINGTest(#group, #name, pystringtest_##group##_##name)); \
@@ -108,12 +130,34 @@ struct AddTest { AddTest(PYSTRINGTest* test); };
 #define PYSTRING_TEST_SETUP() \
     int unit_test_failures = 0
 
+/// The hooks are kept out of line: once GCC inlines both sides it sees delete
+/// handing malloc memory to free and raises -Wmismatched-new-delete.
+#if defined(__GNUC__)
+#define PYSTRING_ALLOCATION_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define PYSTRING_ALLOCATION_NOINLINE __declspec(noinline)
+#else
+#define PYSTRING_ALLOCATION_NOINLINE
+#endif
+
+/// Replaces the global allocation functions with counting versions. Must be
+/// expanded exactly once per test or benchmark binary.
+#define PYSTRING_ALLOCATION_HOOKS()                                         \
+    std::atomic<std::size_t> unit_test_allocations(0);                  \
+    PYSTRING_ALLOCATION_NOINLINE void * operator new(std::size_t size) { \
+        unit_test_allocations.fetch_add(1, std::memory_order_relaxed);  \
+        if (void * p = std::malloc(size ? size : 1)) return p;          \
+        throw std::bad_alloc(); }                                       \
+    PYSTRING_ALLOCATION_NOINLINE void operator delete(void * p) noexcept { std::free(p); } \
+    PYSTRING_ALLOCATION_NOINLINE void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
 #define PYSTRING_TEST_APP(app)                                              \
     std::vector<PYSTRINGTest*>& GetUnitTests() {                            \
         static std::vector<PYSTRINGTest*> pystring_unit_tests;                  \
         return pystring_unit_tests; }                                       \
     AddTest::AddTest(PYSTRINGTest* test){GetUnitTests().push_back(test);};  \
     PYSTRING_TEST_SETUP(); \
+    PYSTRING_ALLOCATION_HOOKS() \
     int main(int, char **) { std::cerr << "\n" << #app <<"\n\n";        \
         for(size_t i = 0; i < GetUnitTests().size(); ++i) {             \
             int _tmp = unit_test_failures; GetUnitTests()[i]->function(); \